@@ -4,8 +4,11 @@
 #include <alpaca/detail/endian.h>
 #include <alpaca/detail/from_bytes.h>
 #include <alpaca/detail/is_specialization.h>
+#include <alpaca/detail/is_wire_trivial.h>
+#include <alpaca/detail/mapped_file.h>
 #include <alpaca/detail/options.h>
 #include <alpaca/detail/print_bytes.h>
+#include <alpaca/detail/source.h>
 #include <alpaca/detail/struct_nth_field.h>
 #include <alpaca/detail/to_bytes.h>
 #include <alpaca/detail/type_info.h>
@@ -13,21 +16,31 @@
 #include <alpaca/detail/types/bitset.h>
 #include <alpaca/detail/types/deque.h>
 #include <alpaca/detail/types/duration.h>
+#include <alpaca/detail/types/field_encoding.h>
 #include <alpaca/detail/types/filesystem_path.h>
 #include <alpaca/detail/types/list.h>
 #include <alpaca/detail/types/map.h>
 #include <alpaca/detail/types/optional.h>
 #include <alpaca/detail/types/pair.h>
 #include <alpaca/detail/types/set.h>
+#include <alpaca/detail/types/span.h>
 #include <alpaca/detail/types/string.h>
+#include <alpaca/detail/types/string_view.h>
 #include <alpaca/detail/types/tuple.h>
 #include <alpaca/detail/types/unique_ptr.h>
 #include <alpaca/detail/types/variant.h>
 #include <alpaca/detail/types/vector.h>
 #include <alpaca/detail/types/glm_vector.h>
+// after the containers that it wraps
+#include <alpaca/detail/types/delta.h>
 #include <alpaca/detail/variable_length_encoding.h>
+#include <algorithm>
+#include <array>
 #include <cassert>
 #include <system_error>
+#if __has_include(<span>)
+#include <span>
+#endif
 
 namespace alpaca {
 
@@ -101,6 +114,18 @@ void type_info_helper(
   }
 }
 
+// crc32 of the type information of T, used as its version
+// calculated once per type and cached
+template <typename T, std::size_t N> uint32_t type_hash() {
+  static const uint32_t hash = [] {
+    std::vector<uint8_t> typeids;
+    std::unordered_map<std::string_view, std::size_t> struct_visitor_map;
+    type_info<T, N>(typeids, struct_visitor_map);
+    return crc32_fast(typeids.data(), typeids.size());
+  }();
+  return hash;
+}
+
 } // namespace detail
 
 namespace detail {
@@ -161,32 +186,81 @@ void to_bytes_router(const std::bitset<N> &input, Container &bytes,
 
 } // namespace detail
 
-template <typename T,
-          std::size_t N = detail::aggregate_arity<std::remove_cv_t<T>>::size(),
-          typename Container = std::vector<uint8_t>>
-std::size_t serialize(const T &s, Container &bytes) {
+namespace detail {
+
+template <options O, typename T, std::size_t N>
+std::size_t count_bytes(const T &s, byte_counter &counter) {
   std::size_t byte_index = 0;
-  detail::serialize_helper<options::none, T, N, Container, 0>(s, bytes,
-                                                              byte_index);
+
+  if constexpr (N > 0 && detail::with_version<O>()) {
+    // uint32_t typeid hash
+    byte_index += sizeof(uint32_t);
+  }
+
+  serialize_helper<O, T, N, byte_counter, 0>(s, counter, byte_index);
+
+  if constexpr (N > 0 && detail::with_checksum<O>()) {
+    // uint32_t crc32 trailer
+    byte_index += sizeof(uint32_t);
+  }
+
   return byte_index;
 }
 
+} // namespace detail
+
+// exact number of bytes that serialize<O>(s, ...) will write,
+// including the version header and the checksum trailer
+template <options O, typename T,
+          std::size_t N = detail::aggregate_arity<std::remove_cv_t<T>>::size()>
+std::size_t serialized_size(const T &s) {
+  detail::byte_counter counter;
+  return detail::count_bytes<O, T, N>(s, counter);
+}
+
+// as above, and sets error_code to std::errc::value_too_large if a string
+// or container in s is too long for its length prefix, i.e., has more than
+// 2^32 - 1 elements without options::wide_lengths
+template <options O, typename T,
+          std::size_t N = detail::aggregate_arity<std::remove_cv_t<T>>::size()>
+std::size_t serialized_size(const T &s, std::error_code &error_code) {
+  detail::byte_counter counter;
+  const auto size = detail::count_bytes<O, T, N>(s, counter);
+  if (counter.size_too_large) {
+    error_code = std::make_error_code(std::errc::value_too_large);
+  }
+  return size;
+}
+
+template <typename T,
+          std::size_t N = detail::aggregate_arity<std::remove_cv_t<T>>::size()>
+std::size_t serialized_size(const T &s) {
+  return serialized_size<options::none, T, N>(s);
+}
+
+template <typename T,
+          std::size_t N = detail::aggregate_arity<std::remove_cv_t<T>>::size()>
+std::size_t serialized_size(const T &s, std::error_code &error_code) {
+  return serialized_size<options::none, T, N>(s, error_code);
+}
+
 // overloads taking options template parameter
 
-// for std::vector and std::array
+// for C-style arrays and raw pointers
+//
+// the bytes are written unchecked - a length that does not fit in its
+// prefix is only asserted, see serialize(s, data, capacity, error_code)
 template <options O, typename T,
           std::size_t N = detail::aggregate_arity<std::remove_cv_t<T>>::size(),
           typename Container>
 typename std::enable_if<!std::is_same_v<Container, std::ofstream> &&
-                            !std::is_array_v<Container>,
+                            (std::is_array_v<Container> ||
+                             std::is_same_v<Container, uint8_t *>),
                         std::size_t>::type
 serialize(const T &s, Container &bytes, std::size_t &byte_index) {
   if constexpr (N > 0 && detail::with_version<O>()) {
-    // calculate typeid hash and save it to the bytearray
-    std::vector<uint8_t> typeids;
-    std::unordered_map<std::string_view, std::size_t> struct_visitor_map;
-    detail::type_info<T, N>(typeids, struct_visitor_map);
-    uint32_t version = crc32_fast(typeids.data(), typeids.size());
+    // typeid hash of T
+    uint32_t version = detail::type_hash<T, N>();
     detail::to_bytes_crc32<O, Container>(bytes, byte_index, version);
   }
 
@@ -195,54 +269,131 @@ serialize(const T &s, Container &bytes, std::size_t &byte_index) {
   if constexpr (N > 0 && detail::with_checksum<O>()) {
     // calculate crc32 for byte array and
     // pack uint32_t to the end
-    uint32_t crc = crc32_fast(bytes.data(), byte_index);
+    uint32_t crc = crc32_fast(bytes, byte_index);
     detail::to_bytes_crc32<O, Container>(bytes, byte_index, crc);
   }
 
   return byte_index;
 }
 
-// for std::fstream
+namespace detail {
+
+// version header, if requested, followed by the fields of s
+template <options O, typename T, std::size_t N, typename Sink>
+void serialize_version_and_fields(const T &s, Sink &sink,
+                                  std::size_t &byte_index) {
+  if constexpr (N > 0 && detail::with_version<O>()) {
+    // typeid hash of T
+    uint32_t version = detail::type_hash<T, N>();
+    to_bytes_crc32<O>(sink, byte_index, version);
+  }
+
+  serialize_helper<O, T, N, Sink, 0>(s, sink, byte_index);
+}
+
+template <options O, typename T, std::size_t N, typename Sink>
+void serialize_to_sink(const T &s, Sink &sink, std::size_t &byte_index) {
+  if constexpr (N > 0 && detail::with_checksum<O>()) {
+    // sinks are write-only - calculate crc32 while writing
+    // and pack uint32_t to the end
+    checksum_sink<Sink> checked_sink{sink};
+    serialize_version_and_fields<O, T, N>(s, checked_sink, byte_index);
+    to_bytes_crc32<O>(sink, byte_index, checked_sink.crc());
+  } else {
+    serialize_version_and_fields<O, T, N>(s, sink, byte_index);
+  }
+}
+
+} // namespace detail
+
+// for Sinks, see alpaca/detail/sink.h
 template <options O, typename T,
           std::size_t N = detail::aggregate_arity<std::remove_cv_t<T>>::size(),
           typename Container>
-typename std::enable_if<std::is_same_v<Container, std::ofstream>,
-                        std::size_t>::type
+typename std::enable_if<detail::is_sink<Container>::value, std::size_t>::type
 serialize(const T &s, Container &bytes, std::size_t &byte_index) {
-  static_assert(!detail::with_version<O>(),
-                "options::with_version is not supported when writing to file");
-  static_assert(!detail::with_checksum<O>(),
-                "options::with_checksum is not supported when writing to file");
-  detail::serialize_helper<O, T, N, Container, 0>(s, bytes, byte_index);
+  if constexpr (!detail::has_noop_reserve<Container>::value) {
+    // hint the exact number of bytes about to be written
+    std::error_code error_code;
+    const auto size = serialized_size<O, T, N>(s, error_code);
+    // a length that does not fit in its prefix is not truncated, nothing is
+    // written instead - see serialize(s, sink, error_code)
+    assert(!error_code && "length does not fit in its prefix");
+    if (error_code) {
+      return byte_index;
+    }
+    bytes.reserve(size);
+  }
+  // otherwise, the bytes are written as they are produced - a length that
+  // does not fit in its prefix is only asserted
+  detail::serialize_to_sink<O, T, N>(s, bytes, byte_index);
   return byte_index;
 }
 
-// for C-style arrays
+// for std::vector and std::array
 template <options O, typename T,
           std::size_t N = detail::aggregate_arity<std::remove_cv_t<T>>::size(),
           typename Container>
 typename std::enable_if<!std::is_same_v<Container, std::ofstream> &&
-                            std::is_array_v<Container>,
+                            !std::is_array_v<Container> &&
+                            !std::is_same_v<Container, uint8_t *> &&
+                            !detail::is_sink<Container>::value,
                         std::size_t>::type
 serialize(const T &s, Container &bytes, std::size_t &byte_index) {
-  if constexpr (N > 0 && detail::with_version<O>()) {
-    // calculate typeid hash and save it to the bytearray
-    std::vector<uint8_t> typeids;
-    std::unordered_map<std::string_view, std::size_t> struct_visitor_map;
-    detail::type_info<T, N>(typeids, struct_visitor_map);
-    uint32_t version = crc32_fast(typeids.data(), typeids.size());
-    detail::to_bytes_crc32<O, Container>(bytes, byte_index, version);
-  }
+  if constexpr (detail::is_resizable_byte_container<Container>::value) {
+    // grow the container once to the exact serialized size
+    // and write the bytes through a raw pointer
+    std::error_code error_code;
+    const auto size = serialized_size<O, T, N>(s, error_code);
+    // a length that does not fit in its prefix is not truncated, nothing is
+    // written instead - see serialize(s, bytes, error_code)
+    assert(!error_code && "length does not fit in its prefix");
+    if (error_code) {
+      return byte_index;
+    }
+    const auto offset = bytes.size();
+    bytes.resize(offset + size);
+    uint8_t *data = reinterpret_cast<uint8_t *>(bytes.data()) + offset;
+    std::size_t index = 0;
+    serialize<O, T, N, uint8_t *>(s, data, index);
+    byte_index += index;
+    return byte_index;
+  } else {
+    // std::array - the bytes are written unchecked, a length that does not
+    // fit in its prefix is only asserted
+    if constexpr (N > 0 && detail::with_version<O>()) {
+      // typeid hash of T
+      uint32_t version = detail::type_hash<T, N>();
+      detail::to_bytes_crc32<O, Container>(bytes, byte_index, version);
+    }
 
-  detail::serialize_helper<O, T, N, Container, 0>(s, bytes, byte_index);
+    detail::serialize_helper<O, T, N, Container, 0>(s, bytes, byte_index);
 
-  if constexpr (N > 0 && detail::with_checksum<O>()) {
-    // calculate crc32 for byte array and
-    // pack uint32_t to the end
-    uint32_t crc = crc32_fast(bytes, byte_index);
-    detail::to_bytes_crc32<O, Container>(bytes, byte_index, crc);
+    if constexpr (N > 0 && detail::with_checksum<O>()) {
+      // calculate crc32 for byte array and
+      // pack uint32_t to the end
+      uint32_t crc = crc32_fast(bytes.data(), byte_index);
+      detail::to_bytes_crc32<O, Container>(bytes, byte_index, crc);
+    }
+
+    return byte_index;
   }
+}
 
+// for std::fstream
+//
+// the bytes are written as they are produced - a length that does not fit in
+// its prefix is only asserted, see serialize(s, os, error_code)
+template <options O, typename T,
+          std::size_t N = detail::aggregate_arity<std::remove_cv_t<T>>::size(),
+          typename Container>
+typename std::enable_if<std::is_same_v<Container, std::ofstream>,
+                        std::size_t>::type
+serialize(const T &s, Container &bytes, std::size_t &byte_index) {
+  // write in large blocks instead of value by value
+  buffered_ostream_sink sink{bytes};
+  detail::serialize_to_sink<O, T, N>(s, sink, byte_index);
+  sink.flush();
   return byte_index;
 }
 
@@ -255,6 +406,201 @@ std::size_t serialize(const T &s, Container &bytes) {
   return byte_index;
 }
 
+template <typename T,
+          std::size_t N = detail::aggregate_arity<std::remove_cv_t<T>>::size(),
+          typename Container = std::vector<uint8_t>>
+std::size_t serialize(const T &s, Container &bytes) {
+  return serialize<options::none, T, N, Container>(s, bytes);
+}
+
+// bounds-checked overloads for caller-provided memory
+
+// Serialize into `capacity` bytes starting at `data`
+//
+// If the serialized object does not fit, nothing is written, error_code is
+// set to std::errc::no_buffer_space and the required number of bytes is
+// returned. If a string or container is too long for its length prefix,
+// nothing is written and error_code is set to std::errc::value_too_large.
+// Otherwise, the number of bytes written is returned
+template <options O, typename T,
+          std::size_t N = detail::aggregate_arity<std::remove_cv_t<T>>::size()>
+std::size_t serialize(const T &s, uint8_t *data, const std::size_t capacity,
+                      std::error_code &error_code) {
+  // check capacity once up front, the bytes are then written unchecked
+  const auto required_size = serialized_size<O, T, N>(s, error_code);
+  if (error_code) {
+    return 0;
+  }
+  if (required_size > capacity) {
+    error_code = std::make_error_code(std::errc::no_buffer_space);
+    return required_size;
+  }
+
+  std::size_t byte_index = 0;
+  serialize<O, T, N, uint8_t *>(s, data, byte_index);
+  return byte_index;
+}
+
+// Append to a resizable container, e.g., std::vector<uint8_t>
+//
+// If a string or container is too long for its length prefix, nothing is
+// written and error_code is set to std::errc::value_too_large. Otherwise,
+// the number of bytes written is returned
+template <options O, typename T,
+          std::size_t N = detail::aggregate_arity<std::remove_cv_t<T>>::size(),
+          typename Container>
+typename std::enable_if<detail::is_resizable_byte_container<Container>::value,
+                        std::size_t>::type
+serialize(const T &s, Container &bytes, std::error_code &error_code) {
+  const auto size = serialized_size<O, T, N>(s, error_code);
+  if (error_code) {
+    return 0;
+  }
+
+  const auto offset = bytes.size();
+  bytes.resize(offset + size);
+  uint8_t *data = reinterpret_cast<uint8_t *>(bytes.data()) + offset;
+  std::size_t byte_index = 0;
+  serialize<O, T, N, uint8_t *>(s, data, byte_index);
+  return byte_index;
+}
+
+// Write to a Sink or a std::ofstream
+//
+// If a string or container is too long for its length prefix, nothing is
+// written and error_code is set to std::errc::value_too_large. Otherwise,
+// the number of bytes written is returned
+template <options O, typename T,
+          std::size_t N = detail::aggregate_arity<std::remove_cv_t<T>>::size(),
+          typename Container>
+typename std::enable_if<detail::is_sink<Container>::value ||
+                            std::is_same_v<Container, std::ofstream>,
+                        std::size_t>::type
+serialize(const T &s, Container &bytes, std::error_code &error_code) {
+  const auto size = serialized_size<O, T, N>(s, error_code);
+  if (error_code) {
+    return 0;
+  }
+
+  std::size_t byte_index = 0;
+  if constexpr (detail::is_sink<Container>::value) {
+    bytes.reserve(size);
+    detail::serialize_to_sink<O, T, N>(s, bytes, byte_index);
+  } else {
+    serialize<O, T, N, Container>(s, bytes, byte_index);
+  }
+  return byte_index;
+}
+
+template <options O, typename T,
+          std::size_t N = detail::aggregate_arity<std::remove_cv_t<T>>::size(),
+          std::size_t M>
+std::size_t serialize(const T &s, std::array<uint8_t, M> &bytes,
+                      std::error_code &error_code) {
+  return serialize<O, T, N>(s, bytes.data(), M, error_code);
+}
+
+template <options O, typename T,
+          std::size_t N = detail::aggregate_arity<std::remove_cv_t<T>>::size(),
+          std::size_t M>
+std::size_t serialize(const T &s, uint8_t (&bytes)[M],
+                      std::error_code &error_code) {
+  return serialize<O, T, N>(s, &bytes[0], M, error_code);
+}
+
+#ifdef __cpp_lib_span
+template <options O, typename T,
+          std::size_t N = detail::aggregate_arity<std::remove_cv_t<T>>::size()>
+std::size_t serialize(const T &s, std::span<uint8_t> bytes,
+                      std::error_code &error_code) {
+  return serialize<O, T, N>(s, bytes.data(), bytes.size(), error_code);
+}
+#endif
+
+template <typename T,
+          std::size_t N = detail::aggregate_arity<std::remove_cv_t<T>>::size()>
+std::size_t serialize(const T &s, uint8_t *data, const std::size_t capacity,
+                      std::error_code &error_code) {
+  return serialize<options::none, T, N>(s, data, capacity, error_code);
+}
+
+template <typename T,
+          std::size_t N = detail::aggregate_arity<std::remove_cv_t<T>>::size(),
+          typename Container>
+typename std::enable_if<detail::is_resizable_byte_container<Container>::value,
+                        std::size_t>::type
+serialize(const T &s, Container &bytes, std::error_code &error_code) {
+  return serialize<options::none, T, N, Container>(s, bytes, error_code);
+}
+
+template <typename T,
+          std::size_t N = detail::aggregate_arity<std::remove_cv_t<T>>::size(),
+          typename Container>
+typename std::enable_if<detail::is_sink<Container>::value ||
+                            std::is_same_v<Container, std::ofstream>,
+                        std::size_t>::type
+serialize(const T &s, Container &bytes, std::error_code &error_code) {
+  return serialize<options::none, T, N, Container>(s, bytes, error_code);
+}
+
+template <typename T,
+          std::size_t N = detail::aggregate_arity<std::remove_cv_t<T>>::size(),
+          std::size_t M>
+std::size_t serialize(const T &s, std::array<uint8_t, M> &bytes,
+                      std::error_code &error_code) {
+  return serialize<options::none, T, N>(s, bytes.data(), M, error_code);
+}
+
+template <typename T,
+          std::size_t N = detail::aggregate_arity<std::remove_cv_t<T>>::size(),
+          std::size_t M>
+std::size_t serialize(const T &s, uint8_t (&bytes)[M],
+                      std::error_code &error_code) {
+  return serialize<options::none, T, N>(s, &bytes[0], M, error_code);
+}
+
+#ifdef __cpp_lib_span
+template <typename T,
+          std::size_t N = detail::aggregate_arity<std::remove_cv_t<T>>::size()>
+std::size_t serialize(const T &s, std::span<uint8_t> bytes,
+                      std::error_code &error_code) {
+  return serialize<options::none, T, N>(s, bytes.data(), bytes.size(),
+                                        error_code);
+}
+#endif
+
+/// Serializes objects of type T into a buffer that is reused across calls
+///
+/// The buffer is cleared, but keeps its capacity, on each call to
+/// serialize(), so serializing many similar objects does not allocate
+/// once the buffer has grown large enough
+template <typename T, options O = options::none,
+          std::size_t N = detail::aggregate_arity<std::remove_cv_t<T>>::size()>
+class serializer {
+public:
+  serializer() = default;
+
+  /// start with room for `capacity` bytes
+  explicit serializer(std::size_t capacity) { buffer_.reserve(capacity); }
+
+  /// serialize s, replacing the previous contents of the buffer
+  ///
+  /// the returned bytes remain valid until the next call
+  const std::vector<uint8_t> &serialize(const T &s) {
+    buffer_.clear();
+    alpaca::serialize<O, T, N>(s, buffer_);
+    return buffer_;
+  }
+
+  /// bytes of the most recently serialized object
+  const std::vector<uint8_t> &bytes() const { return buffer_; }
+
+  std::size_t capacity() const { return buffer_.capacity(); }
+
+private:
+  std::vector<uint8_t> buffer_;
+};
+
 namespace detail {
 
 // Start of deserialization functions
@@ -283,15 +629,83 @@ void from_bytes_router(T &output, Container &bytes, std::size_t &byte_index,
   detail::from_bytes<O>(output, bytes, byte_index, end_index, error_code);
 }
 
+// index of the first field, from field I on, whose size on the wire
+// depends on its value, or N if there is none
+template <options O, typename T, std::size_t N, std::size_t I>
+constexpr std::size_t end_of_fixed_size_fields() {
+  if constexpr (I < N) {
+    using field_type = typename std::decay<decltype(detail::get<I, T, N>(
+        std::declval<T &>()))>::type;
+    if constexpr (fixed_wire_size<O, field_type>() > 0) {
+      return end_of_fixed_size_fields<O, T, N, I + 1>();
+    } else {
+      return I;
+    }
+  } else {
+    return N;
+  }
+}
+
+// number of bytes taken up by fields I, ..., End - 1
+template <options O, typename T, std::size_t N, std::size_t I,
+          std::size_t End>
+constexpr std::size_t fixed_size_fields_size() {
+  if constexpr (I < End) {
+    using field_type = typename std::decay<decltype(detail::get<I, T, N>(
+        std::declval<T &>()))>::type;
+    return fixed_wire_size<O, field_type>() +
+           fixed_size_fields_size<O, T, N, I + 1, End>();
+  } else {
+    return 0;
+  }
+}
+
+/// decode fields I, ..., End - 1, one after the other, without checking
+/// the input - the caller has checked that they are all in the input
+template <options O, typename T, std::size_t N, typename Container,
+          std::size_t I, std::size_t End>
+void deserialize_fixed_size_fields(T &s, Container &bytes,
+                                   std::size_t &byte_index,
+                                   std::size_t &end_index,
+                                   std::error_code &error_code) {
+  if constexpr (I < End) {
+    detail::from_bytes_router<O>(detail::get<I, T, N>(s), bytes, byte_index,
+                                 end_index, error_code);
+    deserialize_fixed_size_fields<O, T, N, Container, I + 1, End>(
+        s, bytes, byte_index, end_index, error_code);
+  }
+}
+
 /// N -> number of fields in struct
 /// I -> field to start from
 template <options O, typename T, std::size_t N, typename Container,
           std::size_t I>
 void deserialize_helper(T &s, Container &bytes, std::size_t &byte_index,
                         std::size_t &end_index, std::error_code &error_code) {
-  if constexpr (I < N) {
+  if constexpr (I < N && pinned_schema<O>() && !trusted_input<O>() &&
+                end_of_fixed_size_fields<O, T, N, I>() > I) {
+    // every field is in the input, so the fields from I on, up to the first
+    // one whose size varies, take up a fixed number of bytes - check that
+    // once instead of field by field
+    constexpr auto end = end_of_fixed_size_fields<O, T, N, I>();
+    constexpr auto size = fixed_size_fields_size<O, T, N, I, end>();
+    if (!has_bytes<O>(size, byte_index, end_index, error_code)) {
+      return;
+    }
+    deserialize_fixed_size_fields<O | options::trusted_input, T, N, Container,
+                                  I, end>(s, bytes, byte_index, end_index,
+                                          error_code);
+    deserialize_helper<O, T, N, Container, end>(s, bytes, byte_index,
+                                                end_index, error_code);
+  } else if constexpr (I < N) {
     decltype(auto) field = detail::get<I, T, N>(s);
 
+    if (end_of_input<O>(byte_index, end_index)) {
+      // field is not in the input, e.g., it was written by an older version
+      // of T - reset it in case s is being reused
+      field = std::remove_reference_t<decltype(field)>{};
+    }
+
     // load current field
     detail::from_bytes_router<O>(field, bytes, byte_index, end_index,
                                  error_code);
@@ -307,6 +721,45 @@ void deserialize_helper(T &s, Container &bytes, std::size_t &byte_index,
   }
 }
 
+// Start of validation functions
+
+/// N -> number of fields in struct
+/// I -> field to start from
+template <options O, typename T, std::size_t N, typename Container,
+          std::size_t I>
+void validate_helper(Container &bytes, std::size_t &byte_index,
+                     std::size_t &end_index, std::error_code &error_code) {
+  if constexpr (I < N) {
+    using field_type = std::remove_cv_t<std::remove_reference_t<decltype(
+        detail::get<I, T, N>(std::declval<T &>()))>>;
+
+    // check current field
+    validate_router<O, field_type>(bytes, byte_index, end_index, error_code);
+
+    if (!error_code) {
+      // go to next field
+      validate_helper<O, T, N, Container, I + 1>(bytes, byte_index, end_index,
+                                                 error_code);
+    }
+  }
+}
+
+// version for nested struct/class types
+template <options O, typename T, typename Container>
+typename std::enable_if<std::is_aggregate_v<T> && !is_array_type<T>::value,
+                        void>::type
+validate_bytes(Container &bytes, std::size_t &byte_index,
+               std::size_t &end_index, std::error_code &error_code) {
+  validate_helper<O, T, detail::aggregate_arity<std::remove_cv_t<T>>::size(),
+                  Container, 0>(bytes, byte_index, end_index, error_code);
+}
+
+template <options O, typename T, typename Container>
+void validate_router(Container &bytes, std::size_t &byte_index,
+                     std::size_t &end_index, std::error_code &error_code) {
+  detail::validate_bytes<O, T>(bytes, byte_index, end_index, error_code);
+}
+
 } // namespace detail
 
 template <typename T,
@@ -314,8 +767,16 @@ template <typename T,
           typename Container>
 void deserialize(T &s, Container &bytes, std::size_t &byte_index,
                  std::size_t &end_index, std::error_code &error_code) {
-  detail::deserialize_helper<options::none, T, N, Container, 0>(
-      s, bytes, byte_index, end_index, error_code);
+  if constexpr (std::is_same_v<Container, std::ifstream>) {
+    // read in large blocks instead of value by value
+    buffered_istream_source source{bytes, end_index - byte_index};
+    detail::deserialize_helper<options::none, T, N, buffered_istream_source,
+                               0>(s, source, byte_index, end_index,
+                                  error_code);
+  } else {
+    detail::deserialize_helper<options::none, T, N, Container, 0>(
+        s, bytes, byte_index, end_index, error_code);
+  }
 }
 
 template <typename T,
@@ -355,13 +816,48 @@ T deserialize(Container &bytes, const std::size_t size,
   return object;
 }
 
+/// Deserialize into an existing object, e.g., one that is reused for every
+/// message of the same type
+///
+/// Containers in s are overwritten in place, keeping their capacity,
+/// and the nodes of lists, maps and sets are reused. Once s has grown to
+/// the size of the messages, deserializing into it no longer allocates
+template <typename T,
+          std::size_t N = detail::aggregate_arity<std::remove_cv_t<T>>::size(),
+          typename Container>
+void deserialize_into(T &s, Container &bytes, std::error_code &error_code) {
+  if (bytes.empty()) {
+    error_code = std::make_error_code(std::errc::message_size);
+    return;
+  }
+
+  std::size_t byte_index = 0;
+  std::size_t end_index = bytes.size();
+  deserialize<T, N, Container>(s, bytes, byte_index, end_index, error_code);
+}
+
+template <typename T,
+          std::size_t N = detail::aggregate_arity<std::remove_cv_t<T>>::size(),
+          typename Container>
+void deserialize_into(T &s, Container &bytes, const std::size_t size,
+                      std::error_code &error_code) {
+  if (size == 0) {
+    error_code = std::make_error_code(std::errc::message_size);
+    return;
+  }
+
+  std::size_t byte_index = 0;
+  std::size_t end_index = size;
+  deserialize<T, N, Container>(s, bytes, byte_index, end_index, error_code);
+}
+
 // Overloads to use options
 
 // For std::vector and std::array
 template <options O, typename T,
           std::size_t N = detail::aggregate_arity<std::remove_cv_t<T>>::size(),
           typename Container>
-typename std::enable_if<!std::is_same_v<Container, std::ifstream> &&
+typename std::enable_if<!detail::is_stream_source<Container>::value &&
                             !std::is_array_v<Container>,
                         void>::type
 deserialize(T &s, Container &bytes, std::size_t &byte_index,
@@ -369,11 +865,8 @@ deserialize(T &s, Container &bytes, std::size_t &byte_index,
 
   if constexpr (N > 0 && detail::with_version<O>()) {
 
-    // calculate typeid hash and save it to the bytearray
-    std::vector<uint8_t> typeids;
-    std::unordered_map<std::string_view, std::size_t> struct_visitor_map;
-    detail::type_info<T, N>(typeids, struct_visitor_map);
-    uint32_t computed_version = crc32_fast(typeids.data(), typeids.size());
+    // typeid hash of T
+    uint32_t computed_version = detail::type_hash<T, N>();
 
     // check computed version with version in input
     // there should be at least 4 bytes in input
@@ -381,10 +874,7 @@ deserialize(T &s, Container &bytes, std::size_t &byte_index,
       error_code = std::make_error_code(std::errc::invalid_argument);
       return;
     } else {
-      std::vector<uint8_t> version_bytes{};
-      for (std::size_t i = 0; i < 4; ++i) {
-        version_bytes.push_back(bytes[byte_index++]);
-      }
+      byte_index += 4;
       uint32_t version = 0;
       std::size_t index = 0;
       detail::from_bytes_crc32<O>(version, bytes, index, end_index,
@@ -409,9 +899,9 @@ deserialize(T &s, Container &bytes, std::size_t &byte_index,
       detail::from_bytes_crc32<O>(trailing_crc, bytes, index, end_index,
                                   error_code); // last 4 bytes
 
-      auto computed_crc = crc32_fast(bytes.data(), end_index - 4);
-
-      if (trailing_crc == computed_crc) {
+      // trusted input has already been validated, checksum included
+      if (detail::trusted_input<O>() ||
+          trailing_crc == crc32_fast(bytes.data(), end_index - 4)) {
         // message is good!
         end_index -= 4;
         detail::deserialize_helper<O, T, N, Container, 0>(
@@ -430,28 +920,111 @@ deserialize(T &s, Container &bytes, std::size_t &byte_index,
   }
 }
 
-// For std::ifstream
+namespace detail {
+
+// version header, if requested, followed by the fields of s
+template <options O, typename T, std::size_t N, typename Source>
+void deserialize_version_and_fields(T &s, Source &source,
+                                    std::size_t &byte_index,
+                                    std::size_t &end_index,
+                                    std::error_code &error_code) {
+  if constexpr (N > 0 && detail::with_version<O>()) {
+
+    // typeid hash of T
+    uint32_t computed_version = detail::type_hash<T, N>();
+
+    // check computed version with version in input
+    // there should be at least 4 bytes in input
+    if (end_index - byte_index < 4) {
+      error_code = std::make_error_code(std::errc::invalid_argument);
+      return;
+    }
+
+    uint32_t version = 0;
+    from_bytes_crc32<O>(version, source, byte_index, end_index,
+                        error_code); // first 4 bytes
+
+    if (version != computed_version) {
+      error_code = std::make_error_code(std::errc::invalid_argument);
+      return;
+    }
+  }
+
+  deserialize_helper<O, T, N, Source, 0>(s, source, byte_index, end_index,
+                                         error_code);
+}
+
+template <options O, typename T, std::size_t N, typename Source>
+void deserialize_from_source(T &s, Source &source, std::size_t &byte_index,
+                             std::size_t &end_index,
+                             std::error_code &error_code) {
+  if constexpr (detail::with_checksum<O>()) {
+    // bytes must be at least 4 bytes long
+    if (end_index - byte_index < 4) {
+      error_code = std::make_error_code(std::errc::invalid_argument);
+      return;
+    }
+
+    // streams can only be read once - calculate crc32 while reading
+    // and check it against the trailing uint32_t
+    checksum_source<Source> checked_source{source};
+    std::size_t checked_end_index = end_index - 4;
+    deserialize_version_and_fields<O, T, N>(s, checked_source, byte_index,
+                                            checked_end_index, error_code);
+    if (error_code) {
+      return;
+    }
+
+    // bytes not consumed by T, e.g., fields added in a newer version,
+    // are part of the checksum too
+    uint8_t skipped[256];
+    while (byte_index < checked_end_index) {
+      const auto size =
+          std::min(sizeof(skipped), checked_end_index - byte_index);
+      checked_source.read(reinterpret_cast<char *>(skipped), size);
+      byte_index += size;
+    }
+
+    uint32_t trailing_crc = 0;
+    from_bytes_crc32<O>(trailing_crc, source, byte_index, end_index,
+                        error_code); // last 4 bytes
+
+    if (trailing_crc != checked_source.crc()) {
+      // message is bad
+      error_code = std::make_error_code(std::errc::bad_message);
+    }
+  } else {
+    deserialize_version_and_fields<O, T, N>(s, source, byte_index, end_index,
+                                            error_code);
+  }
+}
+
+} // namespace detail
+
+// For std::ifstream and buffered_istream_source
 template <options O, typename T,
           std::size_t N = detail::aggregate_arity<std::remove_cv_t<T>>::size(),
           typename Container>
-typename std::enable_if<std::is_same_v<Container, std::ifstream>, void>::type
+typename std::enable_if<detail::is_stream_source<Container>::value,
+                        void>::type
 deserialize(T &s, Container &bytes, std::size_t &byte_index,
             std::size_t &end_index, std::error_code &error_code) {
-  static_assert(
-      !detail::with_version<O>(),
-      "options::with_version is not supported when reading from file");
-  static_assert(
-      !detail::with_checksum<O>(),
-      "options::with_checksum is not supported when reading from file");
-  detail::deserialize_helper<O, T, N, Container, 0>(s, bytes, byte_index,
-                                                    end_index, error_code);
+  if constexpr (std::is_same_v<Container, std::ifstream>) {
+    // read in large blocks instead of value by value
+    buffered_istream_source source{bytes, end_index - byte_index};
+    detail::deserialize_from_source<O, T, N>(s, source, byte_index, end_index,
+                                             error_code);
+  } else {
+    detail::deserialize_from_source<O, T, N>(s, bytes, byte_index, end_index,
+                                             error_code);
+  }
 }
 
 // For C-style arrays
 template <options O, typename T,
           std::size_t N = detail::aggregate_arity<std::remove_cv_t<T>>::size(),
           typename Container>
-typename std::enable_if<!std::is_same_v<Container, std::ifstream> &&
+typename std::enable_if<!detail::is_stream_source<Container>::value &&
                             std::is_array_v<Container>,
                         void>::type
 deserialize(T &s, Container &bytes, std::size_t &byte_index,
@@ -459,11 +1032,8 @@ deserialize(T &s, Container &bytes, std::size_t &byte_index,
 
   if constexpr (N > 0 && detail::with_version<O>()) {
 
-    // calculate typeid hash and save it to the bytearray
-    std::vector<uint8_t> typeids;
-    std::unordered_map<std::string_view, std::size_t> struct_visitor_map;
-    detail::type_info<T, N>(typeids, struct_visitor_map);
-    uint32_t computed_version = crc32_fast(typeids.data(), typeids.size());
+    // typeid hash of T
+    uint32_t computed_version = detail::type_hash<T, N>();
 
     // check computed version with version in input
     // there should be at least 4 bytes in input
@@ -471,10 +1041,7 @@ deserialize(T &s, Container &bytes, std::size_t &byte_index,
       error_code = std::make_error_code(std::errc::invalid_argument);
       return;
     } else {
-      std::vector<uint8_t> version_bytes{};
-      for (std::size_t i = 0; i < 4; ++i) {
-        version_bytes.push_back(bytes[byte_index++]);
-      }
+      byte_index += 4;
       uint32_t version = 0;
       std::size_t index = 0;
       detail::from_bytes_crc32<O>(version, bytes, index, end_index,
@@ -499,9 +1066,9 @@ deserialize(T &s, Container &bytes, std::size_t &byte_index,
       detail::from_bytes_crc32<O>(trailing_crc, bytes, index, end_index,
                                   error_code); // last 4 bytes
 
-      auto computed_crc = crc32_fast(bytes, end_index - 4);
-
-      if (trailing_crc == computed_crc) {
+      // trusted input has already been validated, checksum included
+      if (detail::trusted_input<O>() ||
+          trailing_crc == crc32_fast(bytes, end_index - 4)) {
         // message is good!
         end_index -= 4;
         detail::deserialize_helper<O, T, N, Container, 0>(
@@ -556,4 +1123,125 @@ T deserialize(Container &bytes, std::size_t size, std::error_code &error_code) {
   return object;
 }
 
+template <options O, typename T,
+          std::size_t N = detail::aggregate_arity<std::remove_cv_t<T>>::size(),
+          typename Container>
+void deserialize_into(T &s, Container &bytes, std::error_code &error_code) {
+  if (bytes.empty()) {
+    error_code = std::make_error_code(std::errc::message_size);
+    return;
+  }
+
+  std::size_t byte_index = 0;
+  std::size_t end_index = bytes.size();
+  deserialize<O, T, N, Container>(s, bytes, byte_index, end_index,
+                                  error_code);
+}
+
+template <options O, typename T,
+          std::size_t N = detail::aggregate_arity<std::remove_cv_t<T>>::size(),
+          typename Container>
+void deserialize_into(T &s, Container &bytes, std::size_t size,
+                      std::error_code &error_code) {
+  if (size == 0) {
+    error_code = std::make_error_code(std::errc::message_size);
+    return;
+  }
+
+  std::size_t byte_index = 0;
+  std::size_t end_index = size;
+  deserialize<O, T, N, Container>(s, bytes, byte_index, end_index,
+                                  error_code);
+}
+
+namespace detail {
+
+template <options O, typename T, std::size_t N, typename Container>
+bool validate_message(Container &bytes, std::size_t end_index,
+                      std::error_code &error_code) {
+  std::size_t byte_index = 0;
+
+  if constexpr (N > 0 && detail::with_version<O>()) {
+    // there should be at least 4 bytes in input
+    if (end_index < 4) {
+      error_code = std::make_error_code(std::errc::invalid_argument);
+      return false;
+    }
+
+    uint32_t version = 0;
+    from_bytes_crc32<O>(version, bytes, byte_index, end_index,
+                        error_code); // first 4 bytes
+
+    if (version != detail::type_hash<T, N>()) {
+      error_code = std::make_error_code(std::errc::invalid_argument);
+      return false;
+    }
+  }
+
+  if constexpr (detail::with_checksum<O>()) {
+    // bytes must be at least 4 bytes long
+    if (end_index < 4) {
+      error_code = std::make_error_code(std::errc::invalid_argument);
+      return false;
+    }
+
+    uint32_t trailing_crc = 0;
+    std::size_t index = end_index - 4;
+    from_bytes_crc32<O>(trailing_crc, bytes, index, end_index,
+                        error_code); // last 4 bytes
+
+    if (trailing_crc != crc32_fast(&bytes[0], end_index - 4)) {
+      error_code = std::make_error_code(std::errc::bad_message);
+      return false;
+    }
+    end_index -= 4;
+  }
+
+  validate_helper<O, T, N, Container, 0>(bytes, byte_index, end_index,
+                                         error_code);
+  return !error_code;
+}
+
+} // namespace detail
+
+/// Check that bytes hold a well-formed T, serialized with options O,
+/// without constructing a T or allocating
+///
+/// Every length prefix, variable-length integer, bool and tag, and the
+/// version and checksum if requested, is checked against the input.
+/// Input that passes can be deserialized with options::trusted_input,
+/// which skips the per-value bounds checks
+template <typename T, options O = options::none,
+          std::size_t N = detail::aggregate_arity<std::remove_cv_t<T>>::size(),
+          typename Container>
+bool validate(Container &bytes, std::error_code &error_code) {
+  static_assert(!detail::is_stream_source<Container>::value,
+                "validate requires indexed input, e.g., std::vector<uint8_t>");
+
+  if (bytes.empty()) {
+    error_code = std::make_error_code(std::errc::message_size);
+    return false;
+  }
+
+  return detail::validate_message<detail::untrusted<O>(), T, N>(
+      bytes, bytes.size(), error_code);
+}
+
+template <typename T, options O = options::none,
+          std::size_t N = detail::aggregate_arity<std::remove_cv_t<T>>::size(),
+          typename Container>
+bool validate(Container &bytes, std::size_t size,
+              std::error_code &error_code) {
+  static_assert(!detail::is_stream_source<Container>::value,
+                "validate requires indexed input, e.g., std::vector<uint8_t>");
+
+  if (size == 0) {
+    error_code = std::make_error_code(std::errc::message_size);
+    return false;
+  }
+
+  return detail::validate_message<detail::untrusted<O>(), T, N>(
+      bytes, size, error_code);
+}
+
 } // namespace alpaca
@@ -37,6 +37,10 @@ enum class field_type : uint8_t {
   deque,
   filesystem_path,
   bitset,
+  delta,
+  fixed,
+  varint,
+  bytes,
 };
 
 template <field_type value> constexpr uint8_t to_byte() {
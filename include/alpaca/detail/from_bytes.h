@@ -13,6 +13,34 @@ namespace alpaca {
 
 namespace detail {
 
+// check that `size` more bytes can be read before end_index
+// the check is skipped for trusted, i.e., already validated, input
+template <options O>
+bool has_bytes(std::size_t size, std::size_t current_index,
+               std::size_t end_index, std::error_code &error_code) {
+  if constexpr (!trusted_input<O>()) {
+    if (end_index - current_index < size) {
+      // value is cut off by the end of the input
+      error_code = std::make_error_code(std::errc::message_size);
+      return false;
+    }
+  }
+  return true;
+}
+
+// true if the input ends before the next value, i.e., it was written by an
+// older version of the struct, in which case the value is default
+// initialized for forward compatibility
+//
+// with options::pinned_schema every value is known to be in the input, so
+// the check is skipped - a value that is cut off is still reported by the
+// bounds checks, unless the input is trusted too
+template <options O>
+constexpr bool end_of_input(std::size_t current_index,
+                            std::size_t end_index) {
+  return !pinned_schema<O>() && current_index >= end_index;
+}
+
 template <options O, typename T>
 void get_aligned(T& value, const uint8_t* bytes, size_t current_index)
 {
@@ -27,9 +55,51 @@ void get_aligned(T& value, const uint8_t* bytes, size_t current_index)
   }
 }
 
+// copy `size` contiguous bytes starting at current_index into destination
+template <typename Container>
+typename std::enable_if<!detail::is_stream_source<Container>::value,
+                        void>::type
+copy_bytes_from_range(void *destination, std::size_t size, Container &bytes,
+                      std::size_t &current_index) {
+  std::memcpy(destination, &bytes[0] + current_index, size);
+  current_index += size;
+}
+
+// stream version
+template <typename Container>
+typename std::enable_if<detail::is_stream_source<Container>::value,
+                        void>::type
+copy_bytes_from_range(void *destination, std::size_t size, Container &bytes,
+                      std::size_t &current_index) {
+  bytes.read(static_cast<char *>(destination), size);
+  current_index += size;
+}
+
+// pointer to `count` values of T stored contiguously at current_index,
+// for types that point into the input instead of copying from it
+//
+// error_code is set if the input is not suitably aligned for T
+template <typename T, typename Container>
+const T *borrow_from_range(Container &bytes, std::size_t &current_index,
+                           std::size_t count, std::error_code &error_code) {
+  static_assert(!detail::is_stream_source<Container>::value,
+                "borrowed types, e.g., std::string_view, can not be "
+                "deserialized from a stream");
+  const uint8_t *data =
+      reinterpret_cast<const uint8_t *>(&bytes[0]) + current_index;
+  if (reinterpret_cast<std::uintptr_t>(data) % alignof(T) != 0) {
+    error_code = std::make_error_code(std::errc::bad_address);
+    return nullptr;
+  }
+  current_index += count * sizeof(T);
+  return reinterpret_cast<const T *>(data);
+}
+
 
 template <options O, typename Container>
-typename std::enable_if<!std::is_array_v<Container>, bool>::type
+typename std::enable_if<!detail::is_stream_source<Container>::value &&
+                            !std::is_array_v<Container>,
+                        bool>::type
 from_bytes_crc32(uint32_t &value, Container &bytes, std::size_t &current_index,
                  std::size_t &end_index, std::error_code &) {
   constexpr auto num_bytes_to_read = 4;
@@ -62,11 +132,33 @@ from_bytes_crc32(uint32_t &value, Container &bytes, std::size_t &current_index,
   return true;
 }
 
+// stream version
+template <options O, typename Container>
+typename std::enable_if<detail::is_stream_source<Container>::value,
+                        bool>::type
+from_bytes_crc32(uint32_t &value, Container &bytes, std::size_t &current_index,
+                 std::size_t &end_index, std::error_code &) {
+  constexpr auto num_bytes_to_read = 4;
+
+  if (end_index < num_bytes_to_read) {
+    return false;
+  }
+
+  char value_bytes[num_bytes_to_read];
+  bytes.read(&value_bytes[0], num_bytes_to_read);
+  get_aligned<O>(value, (uint8_t *)&value_bytes[0], 0);
+
+  update_value_based_on_alpaca_endian_rules<O, uint32_t>(value);
+  current_index += num_bytes_to_read;
+  return true;
+}
+
 // char, bool, small ints, float, double
 // read as is
 template <options O, typename T, typename Container>
 typename std::enable_if<
-    !std::is_same_v<Container, std::ifstream> && !std::is_array_v<Container> &&
+    !detail::is_stream_source<Container>::value &&
+        !std::is_array_v<Container> &&
         (std::is_same_v<T, int8_t> || std::is_same_v<T, int16_t> ||
          std::is_same_v<T, uint8_t> || std::is_same_v<T, uint16_t> ||
          std::is_same_v<T, char> || std::is_same_v<T, wchar_t> ||
@@ -77,7 +169,7 @@ typename std::enable_if<
 from_bytes(T &value, Container &bytes, std::size_t &current_index,
            std::size_t &end_index, std::error_code &error_code) {
 
-  if (current_index >= end_index) {
+  if (end_of_input<O>(current_index, end_index)) {
     // end of input
 
     // default initialize the value
@@ -87,24 +179,9 @@ from_bytes(T &value, Container &bytes, std::size_t &current_index,
     return true;
   }
 
-  if constexpr (std::is_same_v<T, uint8_t> || std::is_same_v<T, int8_t>) {
-    // there should be at least 1 byte
-    if (end_index - current_index < 1) {
-      error_code = std::make_error_code(std::errc::message_size);
-      return false;
-    }
-  } else if constexpr (std::is_same_v<T, uint16_t> ||
-                       std::is_same_v<T, int16_t>) {
-    // there should be at least 2 bytes
-    if (end_index - current_index < 2) {
-      error_code = std::make_error_code(std::errc::message_size);
-      return false;
-    }
-  }
-
   constexpr auto num_bytes_to_read = sizeof(T);
-  if (end_index < num_bytes_to_read) {
-    /// TODO: report error
+  if (!has_bytes<O>(num_bytes_to_read, current_index, end_index,
+                    error_code)) {
     return false;
   }
 
@@ -130,7 +207,7 @@ typename std::enable_if<
 from_bytes(T &value, Container &bytes, std::size_t &current_index,
            std::size_t &end_index, std::error_code &error_code) {
 
-  if (current_index >= end_index) {
+  if (end_of_input<O>(current_index, end_index)) {
     // end of input
 
     // default initialize the value
@@ -140,24 +217,9 @@ from_bytes(T &value, Container &bytes, std::size_t &current_index,
     return true;
   }
 
-  if constexpr (std::is_same_v<T, uint8_t> || std::is_same_v<T, int8_t>) {
-    // there should be at least 1 byte
-    if (end_index - current_index < 1) {
-      error_code = std::make_error_code(std::errc::message_size);
-      return false;
-    }
-  } else if constexpr (std::is_same_v<T, uint16_t> ||
-                       std::is_same_v<T, int16_t>) {
-    // there should be at least 2 bytes
-    if (end_index - current_index < 2) {
-      error_code = std::make_error_code(std::errc::message_size);
-      return false;
-    }
-  }
-
   constexpr auto num_bytes_to_read = sizeof(T);
-  if (end_index < num_bytes_to_read) {
-    /// TODO: report error
+  if (!has_bytes<O>(num_bytes_to_read, current_index, end_index,
+                    error_code)) {
     return false;
   }
 
@@ -169,10 +231,10 @@ from_bytes(T &value, Container &bytes, std::size_t &current_index,
 
 // char, bool, small ints, float, double
 // read as is
-// ifstream version
+// stream version
 template <options O, typename T, typename Container>
 typename std::enable_if<
-    std::is_same_v<Container, std::ifstream> &&
+    detail::is_stream_source<Container>::value &&
         (std::is_same_v<T, int8_t> || std::is_same_v<T, int16_t> ||
          std::is_same_v<T, uint8_t> || std::is_same_v<T, uint16_t> ||
          std::is_same_v<T, char> || std::is_same_v<T, wchar_t> ||
@@ -183,7 +245,7 @@ typename std::enable_if<
 from_bytes(T &value, Container &bytes, std::size_t &current_index,
            std::size_t &end_index, std::error_code &error_code) {
 
-  if (current_index >= end_index) {
+  if (end_of_input<O>(current_index, end_index)) {
     // end of input
 
     // default initialize the value
@@ -193,24 +255,9 @@ from_bytes(T &value, Container &bytes, std::size_t &current_index,
     return true;
   }
 
-  if constexpr (std::is_same_v<T, uint8_t> || std::is_same_v<T, int8_t>) {
-    // there should be at least 1 byte
-    if (end_index - current_index < 1) {
-      error_code = std::make_error_code(std::errc::message_size);
-      return false;
-    }
-  } else if constexpr (std::is_same_v<T, uint16_t> ||
-                       std::is_same_v<T, int16_t>) {
-    // there should be at least 2 bytes
-    if (end_index - current_index < 2) {
-      error_code = std::make_error_code(std::errc::message_size);
-      return false;
-    }
-  }
-
   constexpr auto num_bytes_to_read = sizeof(T);
-  if (end_index < num_bytes_to_read) {
-    /// TODO: report error
+  if (!has_bytes<O>(num_bytes_to_read, current_index, end_index,
+                    error_code)) {
     return false;
   }
   char value_bytes[num_bytes_to_read];
@@ -226,15 +273,16 @@ from_bytes(T &value, Container &bytes, std::size_t &current_index,
 // decode variable-length encoding
 template <options O, typename T, typename Container>
 typename std::enable_if<
-    !std::is_same_v<Container, std::ifstream> && !std::is_array_v<Container> &&
+    !detail::is_stream_source<Container>::value &&
+        !std::is_array_v<Container> &&
         (std::is_same_v<T, int32_t> || std::is_same_v<T, long> || std::is_same_v<T, int64_t> ||
          std::is_same_v<T, uint32_t> || std::is_same_v<T, uint64_t> ||
          std::is_same_v<T, std::size_t>),
     bool>::type
 from_bytes(T &value, Container &bytes, std::size_t &current_index,
-           std::size_t &end_index, std::error_code &) {
+           std::size_t &end_index, std::error_code &error_code) {
 
-  if (current_index >= end_index) {
+  if (end_of_input<O>(current_index, end_index)) {
     // end of input
 
     // default initialize the value
@@ -256,14 +304,28 @@ from_bytes(T &value, Container &bytes, std::size_t &current_index,
 
   if constexpr (use_fixed_length_encoding) {
     constexpr auto num_bytes_to_read = sizeof(T);
-    if (end_index < num_bytes_to_read) {
-      /// TODO: report error
+    if (!has_bytes<O>(num_bytes_to_read, current_index, end_index,
+                      error_code)) {
       return false;
     }
     get_aligned<O>(value, &bytes[0], current_index);
     current_index += num_bytes_to_read;
   } else {
-    value = decode_varint<T>(bytes, current_index);
+    if constexpr (!trusted_input<O>()) {
+      // the decoder reads up to max_varint_bytes, so only an encoding
+      // close to the end of the input needs to be checked
+      if (end_index - current_index < max_varint_bytes<T>() &&
+          varint_size<varint_wire_type<O, T>>(bytes, current_index, end_index,
+                                              error_code) == 0) {
+        return false;
+      }
+    }
+    if constexpr (zigzag<O>() && std::is_signed_v<T>) {
+      value = zigzag_decode<T>(decode_varint<varint_wire_type<O, T>>(
+          bytes, current_index, end_index));
+    } else {
+      value = decode_varint<T>(bytes, current_index, end_index);
+    }
   }
 
   update_value_based_on_alpaca_endian_rules<O, T>(value);
@@ -281,9 +343,9 @@ typename std::enable_if<
          std::is_same_v<T, std::size_t>),
     bool>::type
 from_bytes(T &value, Container &bytes, std::size_t &current_index,
-           std::size_t &end_index, std::error_code &) {
+           std::size_t &end_index, std::error_code &error_code) {
 
-  if (current_index >= end_index) {
+  if (end_of_input<O>(current_index, end_index)) {
     // end of input
 
     // default initialize the value
@@ -305,14 +367,28 @@ from_bytes(T &value, Container &bytes, std::size_t &current_index,
 
   if constexpr (use_fixed_length_encoding) {
     constexpr auto num_bytes_to_read = sizeof(T);
-    if (end_index < num_bytes_to_read) {
-      /// TODO: report error
+    if (!has_bytes<O>(num_bytes_to_read, current_index, end_index,
+                      error_code)) {
       return false;
     }
     get_aligned<O>(value, &bytes[0], current_index);
     current_index += num_bytes_to_read;
   } else {
-    value = decode_varint<T>(bytes, current_index);
+    if constexpr (!trusted_input<O>()) {
+      // the decoder reads up to max_varint_bytes, so only an encoding
+      // close to the end of the input needs to be checked
+      if (end_index - current_index < max_varint_bytes<T>() &&
+          varint_size<varint_wire_type<O, T>>(bytes, current_index, end_index,
+                                              error_code) == 0) {
+        return false;
+      }
+    }
+    if constexpr (zigzag<O>() && std::is_signed_v<T>) {
+      value = zigzag_decode<T>(decode_varint<varint_wire_type<O, T>>(
+          bytes, current_index, end_index));
+    } else {
+      value = decode_varint<T>(bytes, current_index, end_index);
+    }
   }
 
   update_value_based_on_alpaca_endian_rules<O, T>(value);
@@ -321,18 +397,18 @@ from_bytes(T &value, Container &bytes, std::size_t &current_index,
 
 // large ints
 // decode variable-length encoding
-// ifstream version
+// stream version
 template <options O, typename T, typename Container>
 typename std::enable_if<
-    std::is_same_v<Container, std::ifstream> &&
+    detail::is_stream_source<Container>::value &&
         (std::is_same_v<T, int32_t> || std::is_same_v<T, int64_t> ||
          std::is_same_v<T, uint32_t> || std::is_same_v<T, uint64_t> ||
          std::is_same_v<T, std::size_t>),
     bool>::type
 from_bytes(T &value, Container &bytes, std::size_t &current_index,
-           std::size_t &end_index, std::error_code &) {
+           std::size_t &end_index, std::error_code &error_code) {
 
-  if (current_index >= end_index) {
+  if (end_of_input<O>(current_index, end_index)) {
     // end of input
 
     // default initialize the value
@@ -354,8 +430,8 @@ from_bytes(T &value, Container &bytes, std::size_t &current_index,
 
   if constexpr (use_fixed_length_encoding) {
     constexpr auto num_bytes_to_read = sizeof(T);
-    if (end_index < num_bytes_to_read) {
-      /// TODO: report error
+    if (!has_bytes<O>(num_bytes_to_read, current_index, end_index,
+                      error_code)) {
       return false;
     }
     char value_bytes[num_bytes_to_read];
@@ -363,7 +439,18 @@ from_bytes(T &value, Container &bytes, std::size_t &current_index,
     current_index += num_bytes_to_read;
     get_aligned<O>(value, (uint8_t*) &value_bytes[0], 0);
   } else {
-    value = decode_varint<T>(bytes, current_index);
+    if constexpr (pinned_schema<O>()) {
+      // the end of input check was skipped
+      if (!has_bytes<O>(1, current_index, end_index, error_code)) {
+        return false;
+      }
+    }
+    if constexpr (zigzag<O>() && std::is_signed_v<T>) {
+      value = zigzag_decode<T>(
+          decode_varint<varint_wire_type<O, T>>(bytes, current_index));
+    } else {
+      value = decode_varint<T>(bytes, current_index);
+    }
   }
 
   update_value_based_on_alpaca_endian_rules<O, T>(value);
@@ -376,7 +463,7 @@ typename std::enable_if<std::is_enum_v<T>, bool>::type
 from_bytes(T &value, Container &bytes, std::size_t &current_index,
            std::size_t &end_index, std::error_code &error_code) {
 
-  if (current_index >= end_index) {
+  if (end_of_input<O>(current_index, end_index)) {
     // end of input
 
     // default initialize the value
@@ -0,0 +1,20 @@
+#pragma once
+#include <cstddef>
+#include <type_traits>
+
+namespace alpaca {
+
+template <std::size_t N> class bytes;
+
+namespace detail {
+
+// check if T is instantiation of alpaca::bytes
+template <typename T>
+struct is_bytes : std::false_type {};
+
+template <std::size_t N>
+struct is_bytes<bytes<N>> : std::true_type {};
+
+} // namespace detail
+
+} // namespace alpaca
@@ -0,0 +1,167 @@
+#pragma once
+#include <alpaca/detail/aggregate_arity.h>
+#include <alpaca/detail/endian.h>
+#include <alpaca/detail/options.h>
+#include <alpaca/detail/struct_nth_field.h>
+#include <alpaca/detail/type_info.h>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+namespace alpaca {
+
+namespace detail {
+
+// types that update_value_based_on_alpaca_endian_rules byte swaps
+template <typename T> constexpr bool is_byte_swapped_type() {
+  return std::is_same_v<T, uint16_t> || std::is_same_v<T, uint32_t> ||
+         std::is_same_v<T, uint64_t> || std::is_same_v<T, int16_t> ||
+         std::is_same_v<T, int32_t> || std::is_same_v<T, int64_t> ||
+         std::is_same_v<T, float> || std::is_same_v<T, double>;
+}
+
+// true if the requested byte order differs from the byte order of the system
+template <options O> constexpr bool byte_swap_required() {
+  return (is_system_big_endian() && detail::little_endian<O>()) ||
+         (is_system_little_endian() && detail::big_endian<O>());
+}
+
+// integers that are variable-length encoded, unless fixed_length_encoding
+// is requested
+template <typename T>
+struct is_varint_integer
+    : std::integral_constant<
+          bool, std::is_same_v<T, int32_t> || std::is_same_v<T, long> ||
+                    std::is_same_v<T, int64_t> ||
+                    std::is_same_v<T, uint32_t> ||
+                    std::is_same_v<T, uint64_t> ||
+                    std::is_same_v<T, std::size_t>> {};
+
+template <options O> constexpr bool uses_fixed_length_encoding() {
+  return (is_system_little_endian() && big_endian<O>()) ||
+         fixed_length_encoding<O>();
+}
+
+template <options O, typename T> constexpr bool wire_trivial();
+
+template <options O, typename T, std::size_t N, std::size_t... I>
+constexpr bool aggregate_wire_trivial(std::index_sequence<I...>) {
+  // every field must be wire-trivial and the fields must cover the entire
+  // struct, i.e., there is no padding between or after them
+  return (wire_trivial<O, typename std::decay<decltype(detail::get<I, T, N>(
+                              std::declval<T &>()))>::type>() &&
+          ...) &&
+         (sizeof(typename std::decay<decltype(detail::get<I, T, N>(
+              std::declval<T &>()))>::type) +
+          ... + 0) == sizeof(T);
+}
+
+template <options O, typename T> constexpr bool wire_trivial() {
+  if constexpr (!std::is_trivially_copyable_v<T> || std::is_const_v<T>) {
+    return false;
+  } else if constexpr (std::is_enum_v<T>) {
+    return wire_trivial<O, typename std::underlying_type<T>::type>();
+  } else if constexpr (std::is_same_v<T, char> || std::is_same_v<T, wchar_t> ||
+                       std::is_same_v<T, char16_t> ||
+                       std::is_same_v<T, char32_t> ||
+                       std::is_same_v<T, uint8_t> ||
+                       std::is_same_v<T, uint16_t> ||
+                       std::is_same_v<T, int8_t> ||
+                       std::is_same_v<T, int16_t> ||
+                       std::is_same_v<T, float> || std::is_same_v<T, double>) {
+    // written as is, possibly byte swapped
+    return !(is_byte_swapped_type<T>() && byte_swap_required<O>());
+  } else if constexpr (std::is_same_v<T, uint32_t> ||
+                       std::is_same_v<T, uint64_t> ||
+                       std::is_same_v<T, int32_t> ||
+                       std::is_same_v<T, int64_t> ||
+                       std::is_same_v<T, unsigned long> ||
+                       std::is_same_v<T, long> ||
+                       std::is_same_v<T, unsigned long long> ||
+                       std::is_same_v<T, long long>) {
+    // variable-length encoded unless fixed length encoding is requested
+    return detail::fixed_length_encoding<O>() &&
+           !(is_byte_swapped_type<T>() && byte_swap_required<O>());
+  } else if constexpr (is_specialization<T, fixed>::value) {
+    // always written as is, possibly byte swapped
+    return sizeof(T) == sizeof(typename T::value_type) &&
+           !(sizeof(T) > 1 && byte_swap_required<O>());
+  } else if constexpr (is_bytes<T>::value) {
+    return sizeof(T) == T::size && !(sizeof(T) > 1 && byte_swap_required<O>());
+  } else if constexpr (is_array_type<T>::value) {
+    using value_type = typename T::value_type;
+    return wire_trivial<O, value_type>() &&
+           sizeof(T) == std::tuple_size<T>::value * sizeof(value_type);
+  } else if constexpr (std::is_aggregate_v<T> && !std::is_union_v<T>) {
+    constexpr auto N = detail::aggregate_arity<T>::size();
+    if constexpr (N == 0) {
+      return false;
+    } else {
+      return aggregate_wire_trivial<O, T, N>(std::make_index_sequence<N>{});
+    }
+  } else {
+    // bool, pointers, STL containers etc.
+    return false;
+  }
+}
+
+template <options O, typename T> constexpr std::size_t fixed_wire_size();
+
+template <options O, typename T, std::size_t N, std::size_t... I>
+constexpr std::size_t aggregate_fixed_wire_size(std::index_sequence<I...>) {
+  constexpr std::size_t sizes[] = {
+      fixed_wire_size<O, typename std::decay<decltype(detail::get<I, T, N>(
+                             std::declval<T &>()))>::type>()...};
+  std::size_t total = 0;
+  for (auto size : sizes) {
+    if (size == 0) {
+      // at least one field varies in size
+      return 0;
+    }
+    total += size;
+  }
+  return total;
+}
+
+// number of bytes that every value of T takes up on the wire,
+// or 0 if that depends on the value, e.g., for varints and containers
+template <options O, typename T> constexpr std::size_t fixed_wire_size() {
+  if constexpr (std::is_enum_v<T>) {
+    return fixed_wire_size<O, typename std::underlying_type<T>::type>();
+  } else if constexpr (is_varint_integer<T>::value) {
+    return uses_fixed_length_encoding<O>() ? sizeof(T) : 0;
+  } else if constexpr (std::is_arithmetic_v<T>) {
+    return sizeof(T);
+  } else if constexpr (is_specialization<T, fixed>::value) {
+    return sizeof(typename T::value_type);
+  } else if constexpr (is_bytes<T>::value) {
+    return T::size;
+  } else if constexpr (is_array_type<T>::value) {
+    return std::tuple_size<T>::value *
+           fixed_wire_size<O, typename T::value_type>();
+  } else if constexpr (std::is_aggregate_v<T> && !std::is_union_v<T>) {
+    constexpr auto N = detail::aggregate_arity<T>::size();
+    if constexpr (N == 0) {
+      return 0;
+    } else {
+      return aggregate_fixed_wire_size<O, T, N>(std::make_index_sequence<N>{});
+    }
+  } else {
+    // pointers, STL containers etc.
+    return 0;
+  }
+}
+
+} // namespace detail
+
+/// T is wire-trivial under options O if its serialized representation is
+/// byte-identical to its in-memory representation, i.e., a contiguous run of
+/// T can be serialized and deserialized with a single memcpy
+template <typename T, options O = options::none>
+struct is_wire_trivial
+    : std::integral_constant<bool, detail::wire_trivial<O, T>()> {};
+
+template <typename T, options O = options::none>
+constexpr bool is_wire_trivial_v = is_wire_trivial<T, O>::value;
+
+} // namespace alpaca
@@ -0,0 +1,236 @@
+#pragma once
+#if __has_include(<sys/mman.h>) && __has_include(<unistd.h>)
+#define ALPACA_HAS_MAPPED_FILE
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <system_error>
+#include <unistd.h>
+#include <utility>
+
+namespace alpaca {
+
+/// Read-only, memory-mapped file
+///
+/// Can be passed to deserialize() like a std::vector<uint8_t>, e.g.,
+///
+///   std::error_code ec;
+///   alpaca::mapped_file file("savefile.bin", ec);
+///   auto object = alpaca::deserialize<GameState>(file, ec);
+///
+/// The bytes are read directly from the page cache, without copying the
+/// file into memory first
+class mapped_file {
+public:
+  /// access pattern hint passed on to madvise
+  enum class advice { normal, sequential, random };
+
+  mapped_file() = default;
+
+  mapped_file(const std::string &path, std::error_code &error_code,
+              advice access = advice::sequential) {
+    open(path, error_code, access);
+  }
+
+  mapped_file(const mapped_file &) = delete;
+  mapped_file &operator=(const mapped_file &) = delete;
+
+  mapped_file(mapped_file &&other) noexcept
+      : data_(std::exchange(other.data_, nullptr)),
+        size_(std::exchange(other.size_, 0)) {}
+
+  mapped_file &operator=(mapped_file &&other) noexcept {
+    if (this != &other) {
+      close();
+      data_ = std::exchange(other.data_, nullptr);
+      size_ = std::exchange(other.size_, 0);
+    }
+    return *this;
+  }
+
+  ~mapped_file() { close(); }
+
+  /// map the file at path, replacing any current mapping
+  void open(const std::string &path, std::error_code &error_code,
+            advice access = advice::sequential) {
+    close();
+
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+      error_code = std::error_code(errno, std::generic_category());
+      return;
+    }
+
+    struct stat file_stat;
+    if (::fstat(fd, &file_stat) < 0) {
+      error_code = std::error_code(errno, std::generic_category());
+      ::close(fd);
+      return;
+    }
+
+    const auto size = static_cast<std::size_t>(file_stat.st_size);
+    if (size > 0) {
+      void *data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (data == MAP_FAILED) {
+        error_code = std::error_code(errno, std::generic_category());
+        ::close(fd);
+        return;
+      }
+      data_ = static_cast<const uint8_t *>(data);
+      size_ = size;
+
+      // only a hint - failure is not an error
+      if (access == advice::sequential) {
+        ::madvise(data, size, MADV_SEQUENTIAL);
+      } else if (access == advice::random) {
+        ::madvise(data, size, MADV_RANDOM);
+      }
+    }
+
+    // the mapping remains valid after the file is closed
+    ::close(fd);
+  }
+
+  /// unmap the file
+  void close() {
+    if (data_ != nullptr) {
+      ::munmap(const_cast<uint8_t *>(data_), size_);
+      data_ = nullptr;
+      size_ = 0;
+    }
+  }
+
+  const uint8_t *data() const { return data_; }
+
+  std::size_t size() const { return size_; }
+
+  bool empty() const { return size_ == 0; }
+
+  const uint8_t &operator[](std::size_t index) const { return data_[index]; }
+
+private:
+  const uint8_t *data_{nullptr};
+  std::size_t size_{0};
+};
+
+/// Sink that serializes directly into a memory-mapped file
+///
+///   std::error_code ec;
+///   alpaca::mapped_file_sink sink("savefile.bin", ec);
+///   alpaca::serialize(object, sink);
+///   sink.close(ec);
+///
+/// The file is grown geometrically with ftruncate, at least by the size
+/// passed to reserve() by serialize(), so that it is remapped only a few
+/// times. close() truncates it to the number of bytes written
+class mapped_file_sink {
+public:
+  static constexpr std::size_t minimum_growth = 1 << 20;
+
+  mapped_file_sink(const std::string &path, std::error_code &error_code) {
+    fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd_ < 0) {
+      error_code = std::error_code(errno, std::generic_category());
+    }
+  }
+
+  mapped_file_sink(const mapped_file_sink &) = delete;
+  mapped_file_sink &operator=(const mapped_file_sink &) = delete;
+
+  ~mapped_file_sink() {
+    std::error_code error_code;
+    close(error_code);
+  }
+
+  void write(const uint8_t *data, std::size_t size) {
+    if (position_ + size > capacity_) {
+      grow(position_ + size);
+    }
+    if (error_) {
+      return;
+    }
+    std::memcpy(data_ + position_, data, size);
+    position_ += size;
+  }
+
+  void reserve(std::size_t size) {
+    if (position_ + size > capacity_) {
+      grow(position_ + size);
+    }
+  }
+
+  std::size_t position() const { return position_; }
+
+  /// unmap the file, truncate it to position() and close it
+  ///
+  /// error_code is set if any write to the file failed
+  void close(std::error_code &error_code) {
+    if (fd_ < 0) {
+      return;
+    }
+    unmap();
+    if (!error_ && ::ftruncate(fd_, static_cast<off_t>(position_)) < 0) {
+      error_ = std::error_code(errno, std::generic_category());
+    }
+    ::close(fd_);
+    fd_ = -1;
+    if (error_) {
+      error_code = error_;
+    }
+  }
+
+private:
+  // grow geometrically to amortize the cost of remapping
+  void grow(std::size_t required) {
+    auto capacity = capacity_ * 2;
+    if (capacity < minimum_growth) {
+      capacity = minimum_growth;
+    }
+    resize(capacity < required ? required : capacity);
+  }
+
+  void resize(std::size_t capacity) {
+    if (error_) {
+      return;
+    }
+    if (fd_ < 0) {
+      error_ = std::make_error_code(std::errc::bad_file_descriptor);
+      return;
+    }
+    unmap();
+    if (::ftruncate(fd_, static_cast<off_t>(capacity)) < 0) {
+      error_ = std::error_code(errno, std::generic_category());
+      return;
+    }
+    void *data =
+        ::mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (data == MAP_FAILED) {
+      error_ = std::error_code(errno, std::generic_category());
+      return;
+    }
+    data_ = static_cast<uint8_t *>(data);
+    capacity_ = capacity;
+  }
+
+  void unmap() {
+    if (data_ != nullptr) {
+      ::munmap(data_, capacity_);
+      data_ = nullptr;
+      capacity_ = 0;
+    }
+  }
+
+  int fd_{-1};
+  uint8_t *data_{nullptr};
+  std::size_t capacity_{0};
+  std::size_t position_{0};
+  std::error_code error_;
+};
+
+} // namespace alpaca
+#endif
@@ -1,4 +1,5 @@
 #pragma once
+#include <cstdint>
 #include <type_traits>
 
 namespace alpaca {
@@ -10,6 +11,12 @@ enum class options {
   with_version = 4,
   with_checksum = 8,
   force_aligned_access = 16,
+  require_sorted_keys = 32,
+  trusted_input = 64,
+  pinned_schema = 128,
+  stream_vbyte = 256,
+  zigzag = 512,
+  wide_lengths = 1024,
 };
 
 template <typename E> struct enable_bitmask_operators {
@@ -58,6 +65,42 @@ template <options O> constexpr bool force_aligned_access() {
   return enum_has_flag<options, O, options::force_aligned_access>();
 }
 
+template <options O> constexpr bool require_sorted_keys() {
+  return enum_has_flag<options, O, options::require_sorted_keys>();
+}
+
+template <options O> constexpr bool trusted_input() {
+  return enum_has_flag<options, O, options::trusted_input>();
+}
+
+template <options O> constexpr bool pinned_schema() {
+  return enum_has_flag<options, O, options::pinned_schema>();
+}
+
+template <options O> constexpr bool stream_vbyte() {
+  return enum_has_flag<options, O, options::stream_vbyte>();
+}
+
+template <options O> constexpr bool zigzag() {
+  return enum_has_flag<options, O, options::zigzag>();
+}
+
+template <options O> constexpr bool wide_lengths() {
+  return enum_has_flag<options, O, options::wide_lengths>();
+}
+
+// type of the length prefix of strings and containers
+template <options O>
+using serialized_size_type =
+    std::conditional_t<wide_lengths<O>(), uint64_t, size_t_serialized_type>;
+
+// O with the trusted_input flag cleared
+template <options O> constexpr options untrusted() {
+  using underlying = typename std::underlying_type<options>::type;
+  return static_cast<options>(static_cast<underlying>(O) &
+                              ~static_cast<underlying>(options::trusted_input));
+}
+
 } // namespace detail
 
 template <> struct enable_bitmask_operators<options> {
@@ -1,6 +1,10 @@
 #pragma once
+#include <alpaca/detail/sink.h>
 #include <array>
+#include <cstddef>
+#include <cstring>
 #include <fstream>
+#include <string>
 #include <system_error>
 #include <vector>
 
@@ -8,6 +12,36 @@ namespace alpaca {
 
 namespace detail {
 
+// resizable containers of byte-sized elements
+// serialize() grows these once to the exact serialized size
+// and then writes to them through a raw pointer
+template <typename T> struct is_resizable_byte_container : std::false_type {};
+
+template <>
+struct is_resizable_byte_container<std::vector<uint8_t>> : std::true_type {};
+
+template <>
+struct is_resizable_byte_container<std::vector<std::byte>> : std::true_type {};
+
+template <>
+struct is_resizable_byte_container<std::vector<char>> : std::true_type {};
+
+template <>
+struct is_resizable_byte_container<std::string> : std::true_type {};
+
+// output "container" that only counts the bytes written to it
+// used to compute the exact serialized size of an object
+struct byte_counter {
+  // set if a string or container is too long for its length prefix
+  bool size_too_large = false;
+};
+
+static inline void append(const uint8_t &, byte_counter &, std::size_t &index) {
+  index += 1;
+}
+
+// only used for the type information hashed by type_hash(), every
+// std::vector<uint8_t> passed to serialize() is written through a raw pointer
 static inline void append(const uint8_t &value, std::vector<uint8_t> &container,
                           std::size_t &index) {
   container.push_back(value);
@@ -25,12 +59,46 @@ static inline void append(const uint8_t &value, uint8_t container[],
   container[index++] = value;
 }
 
-static inline void append(const uint8_t &value, std::ofstream &container,
-                          std::size_t &index) {
-  container << value;
+template <typename Sink>
+typename std::enable_if<is_sink<Sink>::value, void>::type
+append(const uint8_t &value, Sink &sink, std::size_t &index) {
+  sink.write(&value, 1);
   index += 1;
 }
 
+// bulk versions - append `size` contiguous bytes in one go
+
+static inline void append(const uint8_t *, std::size_t size, byte_counter &,
+                          std::size_t &index) {
+  index += size;
+}
+
+static inline void append(const uint8_t *data, std::size_t size,
+                          std::vector<uint8_t> &container, std::size_t &index) {
+  container.insert(container.end(), data, data + size);
+  index += size;
+}
+
+template <std::size_t N>
+void append(const uint8_t *data, std::size_t size,
+            std::array<uint8_t, N> &container, std::size_t &index) {
+  std::memcpy(container.data() + index, data, size);
+  index += size;
+}
+
+static inline void append(const uint8_t *data, std::size_t size,
+                          uint8_t container[], std::size_t &index) {
+  std::memcpy(container + index, data, size);
+  index += size;
+}
+
+template <typename Sink>
+typename std::enable_if<is_sink<Sink>::value, void>::type
+append(const uint8_t *data, std::size_t size, Sink &sink, std::size_t &index) {
+  sink.write(data, size);
+  index += size;
+}
+
 } // namespace detail
 
 } // namespace alpaca
@@ -0,0 +1,102 @@
+#pragma once
+#include <alpaca/detail/from_bytes.h>
+#include <alpaca/detail/output_container.h>
+#include <alpaca/detail/validate.h>
+#include <algorithm>
+#include <cstdint>
+#include <system_error>
+
+namespace alpaca {
+
+namespace detail {
+
+// Bit packing
+//
+// std::bitset and std::vector<bool> are stored 8 bits to a byte, bit i in
+// bit (i % 8) of byte (i / 8), and are converted 64 bits at a time
+
+// number of bytes that hold `size` bits, without overflow for any size
+constexpr std::size_t packed_bits_size(std::size_t size) {
+  return size / 8 + (size % 8 != 0);
+}
+
+// write the low `size` bytes of word, least significant byte first
+template <typename Container>
+void append_packed_word(uint64_t word, std::size_t size, Container &bytes,
+                        std::size_t &byte_index) {
+  uint8_t buffer[sizeof(uint64_t)];
+  for (std::size_t i = 0; i < sizeof(uint64_t); ++i) {
+    buffer[i] = static_cast<uint8_t>(word >> (8 * i));
+  }
+  append(buffer, size, bytes, byte_index);
+}
+
+// read `size` bytes, least significant byte first
+template <typename Container>
+uint64_t read_packed_word(std::size_t size, Container &bytes,
+                          std::size_t &current_index) {
+  uint8_t buffer[sizeof(uint64_t)] = {};
+  copy_bytes_from_range(buffer, size, bytes, current_index);
+  uint64_t word = 0;
+  for (std::size_t i = 0; i < sizeof(uint64_t); ++i) {
+    word |= static_cast<uint64_t>(buffer[i]) << (8 * i);
+  }
+  return word;
+}
+
+// write bits [0, size) of `bits`, e.g., a std::vector<bool>
+template <typename Bits, typename Container>
+void append_packed_bits(const Bits &bits, std::size_t size, Container &bytes,
+                        std::size_t &byte_index) {
+  for (std::size_t i = 0; i < size; i += 64) {
+    const std::size_t count = std::min<std::size_t>(64, size - i);
+    uint64_t word = 0;
+    for (std::size_t j = 0; j < count; ++j) {
+      word |= static_cast<uint64_t>(static_cast<bool>(bits[i + j])) << j;
+    }
+    append_packed_word(word, packed_bits_size(count), bytes, byte_index);
+  }
+}
+
+// read bits [0, size) into `bits`, which already holds at least size bits
+template <typename Bits, typename Container>
+void read_packed_bits(Bits &bits, std::size_t size, Container &bytes,
+                      std::size_t &current_index) {
+  for (std::size_t i = 0; i < size; i += 64) {
+    const std::size_t count = std::min<std::size_t>(64, size - i);
+    const uint64_t word =
+        read_packed_word(packed_bits_size(count), bytes, current_index);
+    for (std::size_t j = 0; j < count; ++j) {
+      bits[i + j] = static_cast<bool>((word >> j) & 1);
+    }
+  }
+}
+
+// size, in bits, followed by the packed bits, e.g., std::vector<bool>
+template <options O, typename Container>
+void validate_packed_bits(Container &bytes, std::size_t &current_index,
+                          std::size_t &end_index,
+                          std::error_code &error_code) {
+  if (end_of_input<O>(current_index, end_index)) {
+    // end of input
+    return;
+  }
+
+  const auto size = validate_size<O>(bytes, current_index, end_index,
+                                     error_code);
+  if (error_code) {
+    return;
+  }
+
+  const std::size_t num_bytes = packed_bits_size(size);
+  if (num_bytes > end_index - current_index) {
+    // size is greater than the number of bits remaining
+    error_code = std::make_error_code(std::errc::value_too_large);
+    return;
+  }
+  current_index += num_bytes;
+}
+
+} // namespace detail
+
+} // namespace alpaca
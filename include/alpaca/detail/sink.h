@@ -0,0 +1,214 @@
+#pragma once
+#include <alpaca/detail/crc32.h>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace alpaca {
+
+/// Sink
+///
+/// An output that serialize() writes bytes to, e.g., a network buffer.
+/// Any type that provides the following members is a Sink:
+///
+///   void write(const uint8_t *data, std::size_t size);
+///     append `size` contiguous bytes to the output
+///
+///   void reserve(std::size_t size);
+///     hint that `size` more bytes are about to be written
+///
+///   std::size_t position() const;
+///     number of bytes written to the sink so far
+///
+/// serialize(object, sink) calls reserve once with the exact serialized size
+/// of object, and then calls write once for each value or contiguous run of
+/// values, e.g., a string or a vector of floats. For the sinks below whose
+/// reserve does nothing, the size is not counted and reserve is not called.
+
+namespace detail {
+
+template <typename T, typename = void> struct is_sink : std::false_type {};
+
+template <typename T>
+struct is_sink<T, std::void_t<decltype(std::declval<T &>().write(
+                                  std::declval<const uint8_t *>(),
+                                  std::declval<std::size_t>())),
+                              decltype(std::declval<T &>().reserve(
+                                  std::declval<std::size_t>())),
+                              decltype(std::declval<const T &>().position())>>
+    : std::true_type {};
+
+// forwards everything to Sink while maintaining a running crc32 of the
+// bytes written
+template <typename Sink> class checksum_sink {
+public:
+  explicit checksum_sink(Sink &sink) : sink_(sink) {}
+
+  void write(const uint8_t *data, std::size_t size) {
+    crc_ = crc32_fast(data, size, crc_);
+    sink_.write(data, size);
+  }
+
+  void reserve(std::size_t size) { sink_.reserve(size); }
+
+  std::size_t position() const { return sink_.position(); }
+
+  uint32_t crc() const { return crc_; }
+
+private:
+  Sink &sink_;
+  uint32_t crc_{0};
+};
+
+} // namespace detail
+
+/// Appends to a resizable container of byte-sized elements,
+/// e.g., std::vector<uint8_t>, std::vector<std::byte> or std::string
+template <typename Container> class container_sink {
+  static_assert(sizeof(typename Container::value_type) == 1,
+                "container_sink requires a container of byte-sized elements");
+
+public:
+  explicit container_sink(Container &container)
+      : container_(container), offset_(container.size()) {}
+
+  void write(const uint8_t *data, std::size_t size) {
+    const auto first =
+        reinterpret_cast<const typename Container::value_type *>(data);
+    container_.insert(container_.end(), first, first + size);
+  }
+
+  void reserve(std::size_t size) {
+    container_.reserve(container_.size() + size);
+  }
+
+  std::size_t position() const { return container_.size() - offset_; }
+
+private:
+  Container &container_;
+  std::size_t offset_;
+};
+
+/// Writes into caller-provided memory of a fixed size
+///
+/// The caller is responsible for providing enough memory,
+/// e.g., using serialized_size()
+class span_sink {
+public:
+  span_sink(uint8_t *data, std::size_t size) : data_(data), size_(size) {}
+
+  void write(const uint8_t *data, std::size_t size) {
+    std::memcpy(data_ + position_, data, size);
+    position_ += size;
+  }
+
+  void reserve(std::size_t) {}
+
+  std::size_t position() const { return position_; }
+
+  uint8_t *data() const { return data_; }
+
+  std::size_t size() const { return size_; }
+
+private:
+  uint8_t *data_;
+  std::size_t size_;
+  std::size_t position_{0};
+};
+
+/// Writes to any std::ostream, e.g., std::ostringstream
+class ostream_sink {
+public:
+  explicit ostream_sink(std::ostream &stream) : stream_(stream) {}
+
+  void write(const uint8_t *data, std::size_t size) {
+    stream_.write(reinterpret_cast<const char *>(data),
+                  static_cast<std::streamsize>(size));
+    position_ += size;
+  }
+
+  void reserve(std::size_t) {}
+
+  std::size_t position() const { return position_; }
+
+private:
+  std::ostream &stream_;
+  std::size_t position_{0};
+};
+
+/// Writes to any std::ostream, e.g., std::ofstream, in large blocks
+///
+/// Bytes are accumulated in an internal buffer of `block_size` bytes
+/// and written to the stream when the buffer is full, on flush(), and
+/// on destruction. Writes larger than the buffer bypass it
+class buffered_ostream_sink {
+public:
+  static constexpr std::size_t default_block_size = 1 << 16;
+
+  explicit buffered_ostream_sink(std::ostream &stream,
+                                 std::size_t block_size = default_block_size)
+      : stream_(stream), buffer_(block_size > 0 ? block_size : 1) {}
+
+  buffered_ostream_sink(const buffered_ostream_sink &) = delete;
+  buffered_ostream_sink &operator=(const buffered_ostream_sink &) = delete;
+
+  ~buffered_ostream_sink() { flush(); }
+
+  void write(const uint8_t *data, std::size_t size) {
+    if (size > buffer_.size() - buffered_) {
+      flush();
+      if (size >= buffer_.size()) {
+        write_to_stream(data, size);
+        position_ += size;
+        return;
+      }
+    }
+    std::memcpy(buffer_.data() + buffered_, data, size);
+    buffered_ += size;
+    position_ += size;
+  }
+
+  void reserve(std::size_t) {}
+
+  std::size_t position() const { return position_; }
+
+  /// write all buffered bytes to the stream
+  void flush() {
+    if (buffered_ > 0) {
+      write_to_stream(buffer_.data(), buffered_);
+      buffered_ = 0;
+    }
+  }
+
+private:
+  void write_to_stream(const uint8_t *data, std::size_t size) {
+    stream_.write(reinterpret_cast<const char *>(data),
+                  static_cast<std::streamsize>(size));
+  }
+
+  std::ostream &stream_;
+  std::vector<uint8_t> buffer_;
+  std::size_t buffered_{0};
+  std::size_t position_{0};
+};
+
+namespace detail {
+
+// sinks whose reserve() does nothing, so serialize() does not
+// count the bytes up front just to call it
+template <typename T> struct has_noop_reserve : std::false_type {};
+
+template <> struct has_noop_reserve<span_sink> : std::true_type {};
+
+template <> struct has_noop_reserve<ostream_sink> : std::true_type {};
+
+template <>
+struct has_noop_reserve<buffered_ostream_sink> : std::true_type {};
+
+} // namespace detail
+
+} // namespace alpaca
@@ -0,0 +1,153 @@
+#pragma once
+#include <alpaca/detail/crc32.h>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <istream>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace alpaca {
+
+/// Reads from any std::istream, e.g., std::ifstream, in large blocks
+///
+/// deserialize() reads `size` bytes through an internal buffer of
+/// `block_size` bytes instead of reading from the stream byte by byte.
+/// At most `size` bytes are read from the stream, so the stream is left
+/// right after the deserialized object. Reads larger than the buffer
+/// bypass it
+class buffered_istream_source {
+public:
+  static constexpr std::size_t default_block_size = 1 << 16;
+
+  buffered_istream_source(std::istream &stream, std::size_t size,
+                          std::size_t block_size = default_block_size)
+      : stream_(stream), remaining_(size),
+        buffer_(block_size > 0 ? block_size : 1) {}
+
+  buffered_istream_source(const buffered_istream_source &) = delete;
+  buffered_istream_source &
+  operator=(const buffered_istream_source &) = delete;
+
+  /// copy the next `size` bytes to destination
+  void read(char *destination, std::size_t size) {
+    auto buffered = std::min(size, available());
+    std::memcpy(destination, buffer_.data() + begin_, buffered);
+    begin_ += buffered;
+    destination += buffered;
+    size -= buffered;
+
+    if (size >= buffer_.size()) {
+      buffered = read_from_stream(destination, size);
+    } else if (size > 0) {
+      refill();
+      buffered = std::min(size, available());
+      std::memcpy(destination, buffer_.data() + begin_, buffered);
+      begin_ += buffered;
+    } else {
+      return;
+    }
+
+    // zero out anything past the end of the stream
+    std::memset(destination + buffered, 0, size - buffered);
+  }
+
+  /// make up to `size` contiguous bytes available, without consuming them,
+  /// and return a pointer to the first one
+  const uint8_t *window(std::size_t size) {
+    if (available() < size) {
+      refill();
+    }
+    return buffer_.data() + begin_;
+  }
+
+  /// number of bytes available in the window
+  std::size_t available() const { return end_ - begin_; }
+
+  /// advance past `size` bytes of the window
+  void consume(std::size_t size) { begin_ += size; }
+
+private:
+  // move the unread bytes to the front of the buffer
+  // and fill the rest from the stream
+  void refill() {
+    if (begin_ > 0) {
+      std::memmove(buffer_.data(), buffer_.data() + begin_, available());
+      end_ -= begin_;
+      begin_ = 0;
+    }
+    const auto count = std::min(buffer_.size() - end_, remaining_);
+    end_ += read_from_stream(buffer_.data() + end_, count);
+  }
+
+  template <typename Byte>
+  std::size_t read_from_stream(Byte *destination, std::size_t size) {
+    const auto requested = std::min(size, remaining_);
+    stream_.read(reinterpret_cast<char *>(destination),
+                 static_cast<std::streamsize>(requested));
+    const auto count = static_cast<std::size_t>(stream_.gcount());
+    // stop reading on error or end of stream
+    remaining_ = count < requested ? 0 : remaining_ - count;
+    return count;
+  }
+
+  std::istream &stream_;
+  std::size_t remaining_;
+  std::vector<uint8_t> buffer_;
+  std::size_t begin_{0};
+  std::size_t end_{0};
+};
+
+namespace detail {
+
+// forwards everything to Source while maintaining a running crc32 of the
+// bytes consumed
+template <typename Source> class checksum_source {
+public:
+  explicit checksum_source(Source &source) : source_(source) {}
+
+  void read(char *destination, std::size_t size) {
+    source_.read(destination, size);
+    crc_ = crc32_fast(destination, size, crc_);
+  }
+
+  const uint8_t *window(std::size_t size) { return source_.window(size); }
+
+  std::size_t available() const { return source_.available(); }
+
+  void consume(std::size_t size) {
+    crc_ = crc32_fast(source_.window(0), size, crc_);
+    source_.consume(size);
+  }
+
+  uint32_t crc() const { return crc_; }
+
+private:
+  Source &source_;
+  uint32_t crc_{0};
+};
+
+// inputs that are read sequentially instead of indexed
+template <typename T> struct is_stream_source : std::false_type {};
+
+template <> struct is_stream_source<std::ifstream> : std::true_type {};
+
+template <>
+struct is_stream_source<buffered_istream_source> : std::true_type {};
+
+template <typename Source>
+struct is_stream_source<checksum_source<Source>> : std::true_type {};
+
+// inputs that expose a contiguous window of buffered bytes
+template <typename T, typename = void> struct has_window : std::false_type {};
+
+template <typename T>
+struct has_window<T, std::void_t<decltype(std::declval<T &>().window(
+                         std::declval<std::size_t>()))>> : std::true_type {};
+
+} // namespace detail
+
+} // namespace alpaca
@@ -0,0 +1,299 @@
+#pragma once
+#include <alpaca/detail/endian.h>
+#include <alpaca/detail/from_bytes.h>
+#include <alpaca/detail/options.h>
+#include <alpaca/detail/output_container.h>
+#include <alpaca/detail/validate.h>
+#include <cstdint>
+#include <cstring>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+#if defined(__SSSE3__)
+#include <tmmintrin.h>
+#endif
+
+namespace alpaca {
+
+namespace detail {
+
+// Stream VByte
+//
+// With options::stream_vbyte, a vector of 32 or 64-bit unsigned integers is
+// written as
+//
+//   size | control bytes | data bytes
+//
+// Each value is stored in the fewest little-endian data bytes that hold it,
+// at least one, and the number of bytes minus one is recorded in a code of
+// 2 bits (32-bit values) or 4 bits (64-bit values) in the control bytes,
+// starting from the low bits of the first control byte
+//
+// Keeping the lengths apart from the values means that the position of
+// every value is known up front, so decoding needs no per-byte branch, and
+// 32-bit values are decoded 4 at a time with a byte shuffle when SSSE3 is
+// available at compile time
+
+template <typename T> constexpr bool is_stream_vbyte_integer() {
+  return std::is_integral_v<T> && std::is_unsigned_v<T> &&
+         !std::is_same_v<T, bool> && (sizeof(T) == 4 || sizeof(T) == 8);
+}
+
+// number of bits in the length code of each value
+template <typename T> constexpr std::size_t stream_vbyte_code_bits() {
+  return sizeof(T) == 4 ? 2 : 4;
+}
+
+template <typename T> constexpr std::size_t stream_vbyte_code_mask() {
+  return (std::size_t{1} << stream_vbyte_code_bits<T>()) - 1;
+}
+
+// number of control bytes for `size` values
+template <typename T>
+constexpr std::size_t stream_vbyte_control_size(std::size_t size) {
+  return (size * stream_vbyte_code_bits<T>() + 7) / 8;
+}
+
+// length of the value at `index`, in bytes
+template <typename T>
+std::size_t stream_vbyte_length(const uint8_t *control, std::size_t index) {
+  constexpr auto bits = stream_vbyte_code_bits<T>();
+  const std::size_t bit = index * bits;
+  return ((control[bit / 8] >> (bit % 8)) & stream_vbyte_code_mask<T>()) + 1;
+}
+
+// lookup tables for a control byte of 4 codes, i.e., for 32-bit values
+struct stream_vbyte_tables {
+  // total length of the 4 values
+  uint8_t length[256];
+  // for each of the 16 decoded bytes, the data byte it comes from,
+  // or 0xff for a zero byte
+  uint8_t shuffle[256][16];
+};
+
+constexpr stream_vbyte_tables make_stream_vbyte_tables() {
+  stream_vbyte_tables tables{};
+  for (std::size_t c = 0; c < 256; ++c) {
+    std::size_t offset = 0;
+    for (std::size_t i = 0; i < 4; ++i) {
+      const std::size_t length = ((c >> (2 * i)) & 3) + 1;
+      for (std::size_t b = 0; b < 4; ++b) {
+        tables.shuffle[c][4 * i + b] =
+            b < length ? static_cast<uint8_t>(offset + b) : 0xff;
+      }
+      offset += length;
+    }
+    tables.length[c] = static_cast<uint8_t>(offset);
+  }
+  return tables;
+}
+
+inline constexpr stream_vbyte_tables stream_vbyte_tables_v =
+    make_stream_vbyte_tables();
+
+// number of data bytes that follow the control bytes of `size` values
+//
+// a 4-bit code can describe up to 16 bytes, more than a 64-bit value can
+// hold, so such a length is an illegal byte sequence
+template <typename T>
+std::size_t stream_vbyte_data_size(const uint8_t *control, std::size_t size,
+                                   std::error_code &error_code) {
+  std::size_t result = 0;
+  std::size_t i = 0;
+  if constexpr (sizeof(T) == 4) {
+    // 4 values per control byte
+    for (; i + 4 <= size; i += 4) {
+      result += stream_vbyte_tables_v.length[control[i / 4]];
+    }
+  }
+  for (; i < size; ++i) {
+    const std::size_t length = stream_vbyte_length<T>(control, i);
+    if (length > sizeof(T)) {
+      error_code = std::make_error_code(std::errc::illegal_byte_sequence);
+      return 0;
+    }
+    result += length;
+  }
+  return result;
+}
+
+// number of bytes that value is stored in, at least one
+template <typename T> std::size_t stream_vbyte_value_length(T value) {
+  std::size_t length = 1;
+  while (length < sizeof(T) && (value >> (8 * length)) != 0) {
+    ++length;
+  }
+  return length;
+}
+
+// the control bytes and then the data bytes are written straight to the
+// output, one pass over the values for each
+template <typename T, typename Container>
+void stream_vbyte_encode(const T *values, std::size_t size, Container &bytes,
+                         std::size_t &byte_index) {
+  constexpr auto bits = stream_vbyte_code_bits<T>();
+
+  uint8_t control = 0;
+  for (std::size_t i = 0; i < size; ++i) {
+    const std::size_t bit = (i * bits) % 8;
+    control |= static_cast<uint8_t>((stream_vbyte_value_length(values[i]) - 1)
+                                    << bit);
+    if (bit + bits == 8 || i + 1 == size) {
+      append(control, bytes, byte_index);
+      control = 0;
+    }
+  }
+
+  for (std::size_t i = 0; i < size; ++i) {
+    const T value = values[i];
+    const std::size_t length = stream_vbyte_value_length(value);
+    if constexpr (is_system_little_endian()) {
+      append(reinterpret_cast<const uint8_t *>(&value), length, bytes,
+             byte_index);
+    } else {
+      uint8_t buffer[sizeof(T)];
+      for (std::size_t b = 0; b < length; ++b) {
+        buffer[b] = static_cast<uint8_t>(value >> (8 * b));
+      }
+      append(buffer, length, bytes, byte_index);
+    }
+  }
+}
+
+// decode `size` values from `data_size` data bytes
+template <typename T>
+void stream_vbyte_decode(const uint8_t *control, const uint8_t *data,
+                         std::size_t data_size, std::size_t size, T *output) {
+  std::size_t i = 0;
+  const uint8_t *const data_end = data + data_size;
+
+#if defined(__SSSE3__)
+  if constexpr (sizeof(T) == 4) {
+    // 4 values at a time, as long as 16 bytes can be loaded
+    for (; i + 4 <= size && data_end - data >= 16; i += 4) {
+      const uint8_t c = control[i / 4];
+      const __m128i input =
+          _mm_loadu_si128(reinterpret_cast<const __m128i *>(data));
+      const __m128i shuffle = _mm_loadu_si128(
+          reinterpret_cast<const __m128i *>(stream_vbyte_tables_v.shuffle[c]));
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(output + i),
+                       _mm_shuffle_epi8(input, shuffle));
+      data += stream_vbyte_tables_v.length[c];
+    }
+  }
+#endif
+
+  for (; i < size; ++i) {
+    const std::size_t length = stream_vbyte_length<T>(control, i);
+    if constexpr (is_system_little_endian()) {
+      if (static_cast<std::size_t>(data_end - data) >= sizeof(uint64_t)) {
+        // load a whole word and keep the low `length` bytes
+        uint64_t word;
+        std::memcpy(&word, data, sizeof(word));
+        output[i] = static_cast<T>(word & (~uint64_t{0} >> (64 - 8 * length)));
+        data += length;
+        continue;
+      }
+    }
+    T value = 0;
+    for (std::size_t b = 0; b < length; ++b) {
+      value |= static_cast<T>(data[b]) << (8 * b);
+    }
+    output[i] = value;
+    data += length;
+  }
+}
+
+// read the control and data bytes of `size` values into value
+template <options O, typename T, typename Container>
+bool stream_vbyte_from_bytes(std::vector<T> &value, std::size_t size,
+                             Container &bytes, std::size_t &current_index,
+                             std::size_t &end_index,
+                             std::error_code &error_code) {
+  const std::size_t control_size = stream_vbyte_control_size<T>(size);
+  if (!has_bytes<O>(control_size, current_index, end_index, error_code)) {
+    return false;
+  }
+
+  if constexpr (is_stream_source<Container>::value) {
+    // read the encoded values into a buffer first
+    std::vector<uint8_t> buffer(control_size);
+    copy_bytes_from_range(buffer.data(), control_size, bytes, current_index);
+    const std::size_t data_size =
+        stream_vbyte_data_size<T>(buffer.data(), size, error_code);
+    if (error_code) {
+      return false;
+    }
+    if (!has_bytes<O>(data_size, current_index, end_index, error_code)) {
+      return false;
+    }
+    buffer.resize(control_size + data_size);
+    copy_bytes_from_range(buffer.data() + control_size, data_size, bytes,
+                          current_index);
+
+    value.resize(size);
+    stream_vbyte_decode<T>(buffer.data(), buffer.data() + control_size,
+                           data_size, size, value.data());
+  } else {
+    const uint8_t *control =
+        reinterpret_cast<const uint8_t *>(&bytes[0]) + current_index;
+    const std::size_t data_size =
+        stream_vbyte_data_size<T>(control, size, error_code);
+    if (error_code) {
+      return false;
+    }
+    if (!has_bytes<O>(control_size + data_size, current_index, end_index,
+                      error_code)) {
+      return false;
+    }
+
+    value.resize(size);
+    stream_vbyte_decode<T>(control, control + control_size, data_size, size,
+                           value.data());
+    current_index += control_size + data_size;
+  }
+  return true;
+}
+
+template <options O, typename T, typename Container>
+void validate_stream_vbyte(Container &bytes, std::size_t &current_index,
+                           std::size_t &end_index,
+                           std::error_code &error_code) {
+  if (end_of_input<O>(current_index, end_index)) {
+    // end of input
+    return;
+  }
+
+  const auto size = validate_size<O>(bytes, current_index, end_index,
+                                     error_code);
+  if (error_code) {
+    return;
+  }
+
+  if (size > end_index - current_index) {
+    // size is greater than the number of bytes remaining
+    error_code = std::make_error_code(std::errc::value_too_large);
+    return;
+  }
+
+  const std::size_t control_size = stream_vbyte_control_size<T>(size);
+  if (!has_bytes<O>(control_size, current_index, end_index, error_code)) {
+    return;
+  }
+  const uint8_t *control =
+      reinterpret_cast<const uint8_t *>(&bytes[0]) + current_index;
+  const std::size_t data_size =
+      stream_vbyte_data_size<T>(control, size, error_code);
+  if (error_code) {
+    return;
+  }
+  if (!has_bytes<O>(control_size + data_size, current_index, end_index,
+                    error_code)) {
+    return;
+  }
+  current_index += control_size + data_size;
+}
+
+} // namespace detail
+
+} // namespace alpaca
@@ -1,7 +1,11 @@
 #pragma once
 #include <alpaca/detail/endian.h>
+#include <alpaca/detail/options.h>
+#include <alpaca/detail/output_container.h>
 #include <alpaca/detail/variable_length_encoding.h>
+#include <cassert>
 #include <iterator>
+#include <limits>
 
 namespace alpaca {
 
@@ -10,11 +14,8 @@ namespace detail {
 template <typename T, typename Container>
 void copy_bytes_in_range(const T &value, Container &bytes,
                          std::size_t &byte_index) {
-  auto start = static_cast<const char *>(static_cast<const void *>(&value));
-  auto end = start + sizeof value;
-  for (auto i = start; i != end; ++i) {
-    append(static_cast<uint8_t>(*i), bytes, byte_index);
-  }
+  append(static_cast<const uint8_t *>(static_cast<const void *>(&value)),
+         sizeof value, bytes, byte_index);
 }
 
 template <options O, typename Container>
@@ -71,6 +72,9 @@ to_bytes(T &bytes, std::size_t &byte_index, const U &original_value) {
 
   if constexpr (use_fixed_length_encoding) {
     copy_bytes_in_range(value, bytes, byte_index);
+  } else if constexpr (zigzag<O>() && std::is_signed_v<U>) {
+    encode_varint<varint_wire_type<O, U>, T>(zigzag_encode(value), bytes,
+                                              byte_index);
   } else {
     encode_varint<U, T>(value, bytes, byte_index);
   }
@@ -86,6 +90,30 @@ to_bytes(T &bytes, std::size_t &byte_index, const U &value) {
                                   static_cast<underlying_type>(value));
 }
 
+// length prefix of a string or container
+//
+// A size that does not fit in serialized_size_type<O> is flagged while
+// counting the bytes to write, see serialized_size(s, error_code), so that
+// it is reported instead of being truncated. Writing such a size is a bug
+// in the caller, who did not check it first
+template <options O, typename Container>
+void to_bytes_size(Container &bytes, std::size_t &byte_index,
+                   std::size_t size) {
+  using size_type = serialized_size_type<O>;
+  if constexpr (sizeof(size_type) < sizeof(std::size_t)) {
+    if constexpr (std::is_same_v<Container, byte_counter>) {
+      if (size > std::numeric_limits<size_type>::max()) {
+        bytes.size_too_large = true;
+      }
+    } else {
+      assert(size <= std::numeric_limits<size_type>::max() &&
+             "length does not fit in its prefix, see options::wide_lengths");
+    }
+  }
+  to_bytes<O, Container, size_type>(bytes, byte_index,
+                                    static_cast<size_type>(size));
+}
+
 } // namespace detail
 
 } // namespace alpaca
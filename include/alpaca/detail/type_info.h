@@ -1,6 +1,7 @@
 #pragma once
 #include <alpaca/detail/field_type.h>
 #include <alpaca/detail/is_bitset.h>
+#include <alpaca/detail/is_bytes.h>
 #include <alpaca/detail/is_specialization.h>
 
 #ifndef ALPACA_EXCLUDE_SUPPORT_STD_ARRAY
@@ -11,6 +12,10 @@
 #include <bitset>
 #endif
 
+#ifndef ALPACA_EXCLUDE_SUPPORT_STD_CHRONO
+#include <chrono>
+#endif
+
 #ifndef ALPACA_EXCLUDE_SUPPORT_STD_FILESYSTEM_PATH
 #include <filesystem>
 #endif
@@ -31,6 +36,12 @@
 #include <set>
 #endif
 
+#ifndef ALPACA_EXCLUDE_SUPPORT_STD_SPAN
+#if __has_include(<span>)
+#include <span>
+#endif
+#endif
+
 #ifndef ALPACA_EXCLUDE_SUPPORT_STD_STRING
 #include <string>
 #endif
@@ -61,6 +72,10 @@
 
 namespace alpaca {
 
+template <typename Container> class delta;
+template <typename T> class fixed;
+template <typename T> class varint;
+
 namespace detail {
 
 template <typename T>
@@ -187,6 +202,16 @@ type_info(
     std::unordered_map<std::string_view, std::size_t> &struct_visitor_map);
 #endif
 
+#ifndef ALPACA_EXCLUDE_SUPPORT_STD_CHRONO
+// std::chrono::duration
+template <typename T>
+typename std::enable_if<is_specialization<T, std::chrono::duration>::value,
+                        void>::type
+type_info(
+    std::vector<uint8_t> &typeids,
+    std::unordered_map<std::string_view, std::size_t> &struct_visitor_map);
+#endif
+
 #ifndef ALPACA_EXCLUDE_SUPPORT_STD_FILESYSTEM_PATH
 // filesystem::path
 template <typename T>
@@ -259,6 +284,27 @@ type_info(std::vector<uint8_t> &typeids,
           std::unordered_map<std::string_view, std::size_t> &);
 #endif
 
+#ifndef ALPACA_EXCLUDE_SUPPORT_STD_SPAN
+#ifdef __cpp_lib_span
+// span
+template <typename T> struct is_span;
+
+template <typename T>
+typename std::enable_if<is_span<T>::value, void>::type
+type_info(std::vector<uint8_t> &typeids,
+          std::unordered_map<std::string_view, std::size_t> &);
+#endif
+#endif
+
+#ifndef ALPACA_EXCLUDE_SUPPORT_STD_STRING_VIEW
+// string_view
+template <typename T>
+typename std::enable_if<is_specialization<T, std::basic_string_view>::value,
+                        void>::type
+type_info(std::vector<uint8_t> &typeids,
+          std::unordered_map<std::string_view, std::size_t> &);
+#endif
+
 #ifndef ALPACA_EXCLUDE_SUPPORT_STD_TUPLE
 // tuple
 template <typename T, std::size_t N, std::size_t I>
@@ -295,6 +341,32 @@ type_info(
     std::unordered_map<std::string_view, std::size_t> &struct_visitor_map);
 #endif
 
+// delta
+template <typename T>
+typename std::enable_if<is_specialization<T, delta>::value, void>::type
+type_info(
+    std::vector<uint8_t> &typeids,
+    std::unordered_map<std::string_view, std::size_t> &struct_visitor_map);
+
+// per-field encoding
+template <typename T>
+typename std::enable_if<is_specialization<T, fixed>::value, void>::type
+type_info(
+    std::vector<uint8_t> &typeids,
+    std::unordered_map<std::string_view, std::size_t> &struct_visitor_map);
+
+template <typename T>
+typename std::enable_if<is_specialization<T, varint>::value, void>::type
+type_info(
+    std::vector<uint8_t> &typeids,
+    std::unordered_map<std::string_view, std::size_t> &struct_visitor_map);
+
+template <typename T>
+typename std::enable_if<is_bytes<T>::value, void>::type
+type_info(
+    std::vector<uint8_t> &typeids,
+    std::unordered_map<std::string_view, std::size_t> &struct_visitor_map);
+
 } // namespace detail
 
 } // namespace alpaca
@@ -1,6 +1,9 @@
 #pragma once
 #ifndef ALPACA_EXCLUDE_SUPPORT_STD_ARRAY
+#include <alpaca/detail/from_bytes.h>
+#include <alpaca/detail/is_wire_trivial.h>
 #include <alpaca/detail/type_info.h>
+#include <alpaca/detail/validate.h>
 #include <array>
 #include <system_error>
 #include <vector>
@@ -25,9 +28,15 @@ void to_bytes_router(const T &input, Container &bytes, std::size_t &byte_index);
 template <options O, typename Container, typename T, std::size_t N>
 void to_bytes(Container &bytes, std::size_t &byte_index,
               const std::array<T, N> &input) {
-  // value of each element in list
-  for (const auto &v : input) {
-    to_bytes_router<O>(v, bytes, byte_index);
+  if constexpr (N > 0 && is_wire_trivial<std::array<T, N>, O>::value) {
+    // elements are byte-identical on the wire - copy them in one go
+    append(reinterpret_cast<const uint8_t *>(input.data()), sizeof(input),
+           bytes, byte_index);
+  } else {
+    // value of each element in list
+    for (const auto &v : input) {
+      to_bytes_router<O>(v, bytes, byte_index);
+    }
   }
 }
 
@@ -39,8 +48,6 @@ template <options O, typename T, typename Container>
 void from_bytes_to_array(T &value, Container &bytes, std::size_t &current_index,
                          std::size_t &end_index, std::error_code &error_code) {
 
-  using decayed_value_type = typename std::decay<typename T::value_type>::type;
-
   constexpr auto size = (size_t_serialized_type) std::tuple_size<T>::value;
 
   if (size > end_index - current_index) {
@@ -51,11 +58,18 @@ void from_bytes_to_array(T &value, Container &bytes, std::size_t &current_index,
     return;
   }
 
-  // read `size` bytes and save to value
+  if constexpr (size > 0 && is_wire_trivial<T, O>::value) {
+    // elements are byte-identical on the wire - copy them in one go
+    if (sizeof(T) <= end_index - current_index) {
+      copy_bytes_from_range(value.data(), sizeof(T), bytes, current_index);
+      return;
+    }
+  }
+
+  // read `size` elements, decoding each one in place
   for (size_t_serialized_type i = 0; i < size; ++i) {
-    decayed_value_type v{};
-    from_bytes_router<O>(v, bytes, current_index, end_index, error_code);
-    value[i] = v;
+    from_bytes_router<O>(value[i], bytes, current_index, end_index,
+                         error_code);
   }
 }
 
@@ -64,7 +78,7 @@ bool from_bytes(std::array<U, N> &output, Container &bytes,
                 std::size_t &byte_index, std::size_t &end_index,
                 std::error_code &error_code) {
 
-  if (byte_index >= end_index) {
+  if (end_of_input<O>(byte_index, end_index)) {
     // end of input
     // return true for forward compatibility
     return true;
@@ -74,6 +88,41 @@ bool from_bytes(std::array<U, N> &output, Container &bytes,
   return true;
 }
 
+template <options O, typename T, typename Container>
+typename std::enable_if<is_array_type<T>::value, void>::type
+validate_bytes(Container &bytes, std::size_t &current_index,
+               std::size_t &end_index, std::error_code &error_code) {
+  if (end_of_input<O>(current_index, end_index)) {
+    // end of input
+    return;
+  }
+
+  using value_type = typename T::value_type;
+  constexpr auto size = std::tuple_size<T>::value;
+
+  if (size > end_index - current_index) {
+    // size is greater than the number of bytes remaining
+    error_code = std::make_error_code(std::errc::value_too_large);
+    return;
+  }
+
+  if constexpr (is_fixed_size_value<value_type, O>()) {
+    // fixed-size values - skip them in one go if they all fit
+    if (sizeof(T) <= end_index - current_index) {
+      current_index += sizeof(T);
+      return;
+    }
+  }
+
+  for (std::size_t i = 0; i < size; ++i) {
+    validate_router<O, value_type>(bytes, current_index, end_index,
+                                   error_code);
+    if (error_code) {
+      return;
+    }
+  }
+}
+
 } // namespace detail
 
 } // namespace alpaca
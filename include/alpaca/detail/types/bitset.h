@@ -1,7 +1,9 @@
 #pragma once
 #ifndef ALPACA_EXCLUDE_SUPPORT_STD_BITSET
+#include <alpaca/detail/packed_bits.h>
 #include <alpaca/detail/to_bytes.h>
 #include <alpaca/detail/type_info.h>
+#include <alpaca/detail/validate.h>
 #include <system_error>
 #include <vector>
 
@@ -26,18 +28,15 @@ template <options O, std::size_t N, typename Container>
 void to_bytes_from_bitset_type(const std::bitset<N> &input, Container &bytes,
                                std::size_t &byte_index) {
   // save bitset size
-  to_bytes_router<O, size_t_serialized_type>((size_t_serialized_type) input.size(), bytes, byte_index);
-
-  // serialize the bitset itself into (bits/8 + 1) bytes
-  int num_bytes = input.size() / 8 + 1;
-  for (int i=0; i < num_bytes; ++i) {
-    uint8_t byte = 0;
-    for (int bit = 0; bit < 8; ++bit) {
-      int bit_index = i * 8 + bit;
-      if (bit_index > input.size()) break;
-      if (input[bit_index]) byte |= (1 << bit);
-    }
-    to_bytes<O>(bytes, byte_index, byte);
+  to_bytes_size<O>(bytes, byte_index, input.size());
+
+  // serialize the bitset itself, packed into (bits + 7)/8 bytes
+  constexpr auto num_bytes = packed_bits_size(N);
+  if constexpr (N <= 64) {
+    // the whole bitset fits in one word
+    append_packed_word(input.to_ullong(), num_bytes, bytes, byte_index);
+  } else {
+    append_packed_bits(input, N, bytes, byte_index);
   }
 }
 
@@ -56,15 +55,15 @@ bool from_bytes_to_bitset(std::bitset<N> &value, Container &bytes,
                           std::size_t &current_index, std::size_t &end_index,
                           std::error_code &error_code) {
 
-  if (current_index >= end_index) {
+  if (end_of_input<O>(current_index, end_index)) {
     // end of input
     // return true for forward compatibility
     return true;
   }
 
   // current byte is the size of the vector
-  size_t_serialized_type size = 0;
-  detail::from_bytes<O, size_t_serialized_type>(size, bytes, current_index, end_index,
+  serialized_size_type<O> size = 0;
+  detail::from_bytes<O, serialized_size_type<O>>(size, bytes, current_index, end_index,
                                      error_code);
 
   if (size != N) {
@@ -76,8 +75,8 @@ bool from_bytes_to_bitset(std::bitset<N> &value, Container &bytes,
   }
 
   // we encode the number of bits as the size, but when we actually serialize
-  // them we pack them, so we need to only deserialize (size/8 + 1) bytes.
-  std::size_t num_serialized_bytes = size / 8 + 1;
+  // them we pack them, so we need to only deserialize (size + 7)/8 bytes.
+  constexpr auto num_serialized_bytes = packed_bits_size(N);
 
   if (num_serialized_bytes > end_index - current_index) {
     // size is greater than the number of bytes remaining
@@ -87,23 +86,12 @@ bool from_bytes_to_bitset(std::bitset<N> &value, Container &bytes,
     return false;
   }
 
-  // reset the value to 0
-  value.reset();
-
-  for (size_t_serialized_type i = 0; i < num_serialized_bytes; ++i) {
-    uint8_t byte{};
-    from_bytes_router<O>(byte, bytes, current_index, end_index, error_code);
-    if (error_code) {
-      // something went wrong
-      return false;
-    }
-    // loop over the bits
-    for (int j=0; j<8; ++j) {
-      int bit_index = i * 8 + j;
-      if (bit_index > size) break;
-      bool bit = static_cast<bool>(byte & (1 << j));
-      value[bit_index] = bit;
-    }
+  if constexpr (N <= 64) {
+    // the whole bitset fits in one word - bits past N are dropped
+    value = std::bitset<N>(
+        read_packed_word(num_serialized_bytes, bytes, current_index));
+  } else {
+    read_packed_bits(value, N, bytes, current_index);
   }
 
   return true;
@@ -117,6 +105,37 @@ bool from_bytes(std::bitset<N> &output, Container &bytes,
                                  error_code);
 }
 
+template <options O, typename T, typename Container>
+typename std::enable_if<is_bitset<T>::value, void>::type
+validate_bytes(Container &bytes, std::size_t &current_index,
+               std::size_t &end_index, std::error_code &error_code) {
+  if (end_of_input<O>(current_index, end_index)) {
+    // end of input
+    return;
+  }
+
+  const auto size =
+      validate_size<O>(bytes, current_index, end_index, error_code);
+  if (error_code) {
+    return;
+  }
+
+  if (size != T{}.size()) {
+    // the bitset in the input is not the same size as T
+    error_code = std::make_error_code(std::errc::invalid_argument);
+    return;
+  }
+
+  // the bits are packed into (size + 7)/8 bytes
+  const std::size_t num_serialized_bytes = packed_bits_size(size);
+  if (num_serialized_bytes > end_index - current_index) {
+    // size is greater than the number of bytes remaining
+    error_code = std::make_error_code(std::errc::value_too_large);
+    return;
+  }
+  current_index += num_serialized_bytes;
+}
+
 } // namespace detail
 
 } // namespace alpaca
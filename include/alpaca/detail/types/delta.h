@@ -0,0 +1,267 @@
+#pragma once
+#include <alpaca/detail/from_bytes.h>
+#include <alpaca/detail/options.h>
+#include <alpaca/detail/to_bytes.h>
+#include <alpaca/detail/type_info.h>
+#include <alpaca/detail/validate.h>
+#include <alpaca/detail/variable_length_encoding.h>
+#ifndef ALPACA_EXCLUDE_SUPPORT_STD_CHRONO
+#include <chrono>
+#endif
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace alpaca {
+
+/// Serializes a container of integers or std::chrono::duration, e.g.,
+/// std::vector<uint64_t>, std::deque<std::chrono::nanoseconds> or
+/// std::set<uint32_t>, as the differences between consecutive values
+///
+/// Sorted IDs and timestamps are large, but close to each other, so the
+/// differences take up far fewer bytes than the values themselves.
+/// delta<Container> is a Container, and can be used in its place:
+///
+///   struct Events {
+///     alpaca::delta<std::vector<uint64_t>> timestamps;
+///   };
+template <typename Container> class delta : public Container {
+public:
+  using container_type = Container;
+  using Container::Container;
+
+  delta() = default;
+  delta(const Container &values) : Container(values) {}
+  delta(Container &&values) : Container(std::move(values)) {}
+};
+
+namespace detail {
+
+// integer representation of the values of a delta container
+template <typename T, typename = void> struct delta_traits {};
+
+template <typename T>
+struct delta_traits<T, typename std::enable_if<std::is_integral_v<T> &&
+                                               !std::is_same_v<T, bool>>::type> {
+  using rep = T;
+  static rep to_rep(const T &value) { return value; }
+  static T from_rep(rep value) { return value; }
+};
+
+#ifndef ALPACA_EXCLUDE_SUPPORT_STD_CHRONO
+template <typename Rep, typename Period>
+struct delta_traits<std::chrono::duration<Rep, Period>,
+                    typename std::enable_if<std::is_integral_v<Rep>>::type> {
+  using rep = Rep;
+  static rep to_rep(const std::chrono::duration<Rep, Period> &value) {
+    return value.count();
+  }
+  static std::chrono::duration<Rep, Period> from_rep(rep value) {
+    return std::chrono::duration<Rep, Period>{value};
+  }
+};
+#endif
+
+// unsigned type of the differences between the values of a Container
+template <typename Container>
+using delta_type = std::make_unsigned_t<
+    typename delta_traits<typename Container::value_type>::rep>;
+
+// The differences are ZigZag-encoded, so that a sequence that is not
+// sorted still round-trips, and always variable-length encoded. With
+// options::pinned_schema, a difference that is cut off by the end of the
+// input is an error instead of being read as 0
+template <options O> constexpr options delta_options() {
+  using underlying = typename std::underlying_type<options>::type;
+  constexpr auto clear = static_cast<underlying>(options::big_endian) |
+                         static_cast<underlying>(options::fixed_length_encoding);
+  return static_cast<options>(
+      (static_cast<underlying>(O) & ~clear) |
+      static_cast<underlying>(options::pinned_schema));
+}
+
+template <typename T>
+typename std::enable_if<is_specialization<T, delta>::value, void>::type
+type_info(
+    std::vector<uint8_t> &typeids,
+    std::unordered_map<std::string_view, std::size_t> &struct_visitor_map) {
+  typeids.push_back(to_byte<field_type::delta>());
+  using container_type = typename T::container_type;
+  type_info<container_type>(typeids, struct_visitor_map);
+}
+
+template <options O, typename T, typename Container>
+void to_bytes_router(const T &input, Container &bytes, std::size_t &byte_index);
+
+template <options O, typename Container, typename U>
+typename std::enable_if<is_specialization<U, delta>::value, void>::type
+to_bytes(Container &bytes, std::size_t &byte_index, const U &input) {
+  using T = typename U::container_type;
+
+  // save size
+  to_bytes_size<O>(bytes, byte_index, input.size());
+
+  using traits = delta_traits<typename T::value_type>;
+  using uint_t = delta_type<T>;
+  using int_t = std::make_signed_t<uint_t>;
+
+  // save each value as the difference from the previous one,
+  // starting from 0
+  uint_t previous = 0;
+  for (const auto &value : input) {
+    const auto current = static_cast<uint_t>(traits::to_rep(value));
+    const auto difference = static_cast<int_t>(
+        static_cast<uint_t>(current - previous));
+    to_bytes_router<delta_options<O>()>(zigzag_encode(difference), bytes,
+                                        byte_index);
+    previous = current;
+  }
+}
+
+template <options O, typename T, typename Container>
+void from_bytes_router(T &output, Container &bytes, std::size_t &byte_index,
+                       std::size_t &end_index, std::error_code &error_code);
+
+// turn ZigZag-encoded differences into the values, in place
+template <typename uint_t>
+void delta_prefix_sum(uint_t *values, std::size_t size) {
+  using int_t = std::make_signed_t<uint_t>;
+  std::size_t i = 0;
+  uint_t previous = 0;
+
+#if defined(__SSE2__)
+  if constexpr (sizeof(uint_t) == 4) {
+    // 4 at a time - undo ZigZag, then add each lane to the lanes after it,
+    // 1 and then 2 lanes over, and add the last value of the previous block
+    const __m128i one = _mm_set1_epi32(1);
+    __m128i carry = _mm_setzero_si128();
+    for (; i + 4 <= size; i += 4) {
+      __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(values + i));
+      x = _mm_xor_si128(_mm_srli_epi32(x, 1),
+                        _mm_sub_epi32(_mm_setzero_si128(),
+                                      _mm_and_si128(x, one)));
+      x = _mm_add_epi32(x, _mm_slli_si128(x, 4));
+      x = _mm_add_epi32(x, _mm_slli_si128(x, 8));
+      x = _mm_add_epi32(x, carry);
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(values + i), x);
+      carry = _mm_shuffle_epi32(x, _MM_SHUFFLE(3, 3, 3, 3));
+    }
+    if (i > 0) {
+      previous = values[i - 1];
+    }
+  }
+#endif
+
+  for (; i < size; ++i) {
+    previous = static_cast<uint_t>(
+        previous + static_cast<uint_t>(zigzag_decode<int_t>(values[i])));
+    values[i] = previous;
+  }
+}
+
+template <options O, typename U, typename Container>
+typename std::enable_if<is_specialization<U, delta>::value, bool>::type
+from_bytes(U &output, Container &bytes, std::size_t &current_index,
+           std::size_t &end_index, std::error_code &error_code) {
+  using T = typename U::container_type;
+
+  if (end_of_input<O>(current_index, end_index)) {
+    // end of input
+    // return true for forward compatibility
+    return true;
+  }
+
+  // current byte is the size of the container
+  serialized_size_type<O> size = 0;
+  detail::from_bytes<O, serialized_size_type<O>>(size, bytes, current_index,
+                                                end_index, error_code);
+
+  if (size > end_index - current_index) {
+    // size is greater than the number of bytes remaining
+    error_code = std::make_error_code(std::errc::value_too_large);
+
+    // stop here
+    return false;
+  }
+
+  using value_type = typename T::value_type;
+  using traits = delta_traits<value_type>;
+  using uint_t = delta_type<T>;
+
+  // read all the differences first, then add them up in one pass
+  auto read_values = [&](uint_t *values) {
+    for (std::size_t i = 0; i < size; ++i) {
+      from_bytes_router<delta_options<O>()>(values[i], bytes, current_index,
+                                            end_index, error_code);
+      if (error_code) {
+        // something went wrong
+        return false;
+      }
+    }
+    delta_prefix_sum(values, size);
+    return true;
+  };
+
+  if constexpr (is_specialization<T, std::vector>::value &&
+                std::is_integral_v<value_type>) {
+    // decode in place - value_type and uint_t differ in signedness at most
+    output.resize(size);
+    if (!read_values(reinterpret_cast<uint_t *>(output.data()))) {
+      output.clear();
+      return false;
+    }
+  } else {
+    std::vector<uint_t> values(size);
+    if (!read_values(values.data())) {
+      return false;
+    }
+    output.clear();
+    if constexpr (is_specialization<T, std::vector>::value) {
+      output.reserve(size);
+    }
+    for (const auto &value : values) {
+      output.insert(output.end(), traits::from_rep(
+                                      static_cast<typename traits::rep>(value)));
+    }
+  }
+
+  return true;
+}
+
+template <options O, typename T, typename Container>
+typename std::enable_if<is_specialization<T, delta>::value, void>::type
+validate_bytes(Container &bytes, std::size_t &byte_index,
+               std::size_t &end_index, std::error_code &error_code) {
+  if (end_of_input<O>(byte_index, end_index)) {
+    // end of input
+    return;
+  }
+
+  const auto size = validate_size<O>(bytes, byte_index, end_index, error_code);
+  if (error_code) {
+    return;
+  }
+
+  if (size > end_index - byte_index) {
+    // size is greater than the number of bytes remaining
+    error_code = std::make_error_code(std::errc::value_too_large);
+    return;
+  }
+
+  using uint_t = delta_type<typename T::container_type>;
+  for (std::size_t i = 0; i < size; ++i) {
+    validate_router<delta_options<O>(), uint_t>(bytes, byte_index, end_index,
+                                                error_code);
+    if (error_code) {
+      return;
+    }
+  }
+}
+
+} // namespace detail
+
+} // namespace alpaca
@@ -2,6 +2,7 @@
 #ifndef ALPACA_EXCLUDE_SUPPORT_STD_DEQUE
 #include <alpaca/detail/to_bytes.h>
 #include <alpaca/detail/type_info.h>
+#include <alpaca/detail/validate.h>
 #include <deque>
 #include <system_error>
 
@@ -26,7 +27,7 @@ template <options O, typename T, typename Container>
 void to_bytes_from_deque_type(const T &input, Container &bytes,
                               std::size_t &byte_index) {
   // save deque size
-  to_bytes_router<O, size_t_serialized_type>(input.size(), bytes, byte_index);
+  to_bytes_size<O>(bytes, byte_index, input.size());
 
   // value of each element in deque
   for (const auto &v : input) {
@@ -50,15 +51,15 @@ bool from_bytes_to_deque(std::deque<T> &value, Container &bytes,
                          std::size_t &current_index, std::size_t &end_index,
                          std::error_code &error_code) {
 
-  if (current_index >= end_index) {
+  if (end_of_input<O>(current_index, end_index)) {
     // end of input
     // return true for forward compatibility
     return true;
   }
 
   // current byte is the size of the vector
-  size_t_serialized_type size = 0;
-  detail::from_bytes<O, size_t_serialized_type>(size, bytes, current_index, end_index,
+  serialized_size_type<O> size = 0;
+  detail::from_bytes<O, serialized_size_type<O>>(size, bytes, current_index, end_index,
                                      error_code);
 
   if (size > end_index - current_index) {
@@ -69,15 +70,17 @@ bool from_bytes_to_deque(std::deque<T> &value, Container &bytes,
     return false;
   }
 
-  // read `size` bytes and save to value
-  for (size_t_serialized_type i = 0; i < size; ++i) {
-    T v{};
-    from_bytes_router<O>(v, bytes, current_index, end_index, error_code);
+  // read `size` elements into value, reusing the existing elements
+  // if value is not empty
+  value.resize(size);
+  for (std::size_t i = 0; i < size; ++i) {
+    from_bytes_router<O>(value[i], bytes, current_index, end_index,
+                         error_code);
     if (error_code) {
       // something went wrong
+      value.resize(i);
       return false;
     }
-    value.push_back(v);
   }
 
   return true;
@@ -91,6 +94,14 @@ bool from_bytes(std::deque<T> &output, Container &bytes,
                                 error_code);
 }
 
+template <options O, typename T, typename Container>
+typename std::enable_if<is_specialization<T, std::deque>::value, void>::type
+validate_bytes(Container &bytes, std::size_t &byte_index,
+               std::size_t &end_index, std::error_code &error_code) {
+  validate_sequence<O, typename T::value_type>(bytes, byte_index, end_index,
+                                               error_code);
+}
+
 } // namespace detail
 
 } // namespace alpaca
@@ -2,6 +2,7 @@
 #ifndef ALPACA_EXCLUDE_SUPPORT_STD_CHRONO
 #include <alpaca/detail/options.h>
 #include <alpaca/detail/type_info.h>
+#include <alpaca/detail/validate.h>
 #include <chrono>
 #include <system_error>
 #include <vector>
@@ -42,7 +43,7 @@ bool from_bytes(std::chrono::duration<Rep, Period> &output, Container &bytes,
                 std::size_t &byte_index, std::size_t &end_index,
                 std::error_code &error_code) {
 
-  if (byte_index >= end_index) {
+  if (end_of_input<O>(byte_index, end_index)) {
     // end of input
     // return true for forward compatibility
     return true;
@@ -59,6 +60,15 @@ bool from_bytes(std::chrono::duration<Rep, Period> &output, Container &bytes,
   return true;
 }
 
+template <options O, typename T, typename Container>
+typename std::enable_if<is_specialization<T, std::chrono::duration>::value,
+                        void>::type
+validate_bytes(Container &bytes, std::size_t &byte_index,
+               std::size_t &end_index, std::error_code &error_code) {
+  validate_router<O, typename T::rep>(bytes, byte_index, end_index,
+                                      error_code);
+}
+
 } // namespace detail
 
 } // namespace alpaca
@@ -0,0 +1,277 @@
+#pragma once
+#include <alpaca/detail/from_bytes.h>
+#include <alpaca/detail/options.h>
+#include <alpaca/detail/output_container.h>
+#include <alpaca/detail/to_bytes.h>
+#include <alpaca/detail/type_info.h>
+#include <alpaca/detail/validate.h>
+#include <cstdint>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+
+namespace alpaca {
+
+// Per-field encoding
+//
+// options::fixed_length_encoding applies to every integer in a message.
+// These wrappers override the encoding of a single field, and are used
+// just like the integer that they hold:
+//
+//   struct Entry {
+//     alpaca::fixed<uint64_t> hash;   // always 8 bytes
+//     alpaca::varint<uint32_t> count; // always variable-length encoded
+//     alpaca::bytes<5> offset;        // always 5 bytes
+//   };
+//
+// The wrapper is part of the type information, so changing the encoding of
+// a field changes the version of the struct
+
+/// Integer that is always written in sizeof(T) bytes, e.g., a hash value
+/// whose variable-length encoding would take up more bytes than it saves
+template <typename T> class fixed {
+  static_assert(std::is_integral_v<T> && !std::is_same_v<T, bool>,
+                "alpaca::fixed<T> requires an integer type");
+
+public:
+  using value_type = T;
+
+  constexpr fixed() = default;
+  constexpr fixed(T value) : value_(value) {}
+
+  constexpr operator T &() { return value_; }
+  constexpr operator const T &() const { return value_; }
+
+  constexpr T &value() { return value_; }
+  constexpr const T &value() const { return value_; }
+
+private:
+  T value_{};
+};
+
+/// 32 or 64-bit integer that is always variable-length encoded, e.g., a
+/// counter that is usually small, even with options::fixed_length_encoding
+template <typename T> class varint {
+  static_assert(std::is_integral_v<T> && !std::is_same_v<T, bool> &&
+                    sizeof(T) >= sizeof(uint32_t),
+                "alpaca::varint<T> requires a 32 or 64-bit integer type");
+
+public:
+  using value_type = T;
+
+  constexpr varint() = default;
+  constexpr varint(T value) : value_(value) {}
+
+  constexpr operator T &() { return value_; }
+  constexpr operator const T &() const { return value_; }
+
+  constexpr T &value() { return value_; }
+  constexpr const T &value() const { return value_; }
+
+private:
+  T value_{};
+};
+
+namespace detail {
+
+// smallest unsigned integer type with at least N bytes
+template <std::size_t N>
+using bytes_value_type = std::conditional_t<
+    N <= 1, uint8_t,
+    std::conditional_t<N <= 2, uint16_t,
+                       std::conditional_t<N <= 4, uint32_t, uint64_t>>>;
+
+} // namespace detail
+
+/// Unsigned integer that is always written in exactly N bytes, 1 <= N <= 8,
+/// e.g., a file offset or a millisecond timestamp that fits in 5 or 6 bytes
+///
+/// Only the low N bytes of the value are written
+template <std::size_t N> class bytes {
+  static_assert(N >= 1 && N <= sizeof(uint64_t),
+                "alpaca::bytes<N> requires 1 <= N <= 8");
+
+public:
+  using value_type = detail::bytes_value_type<N>;
+  static constexpr std::size_t size = N;
+
+  constexpr bytes() = default;
+  constexpr bytes(value_type value) : value_(value) {}
+
+  constexpr operator value_type &() { return value_; }
+  constexpr operator const value_type &() const { return value_; }
+
+  constexpr value_type &value() { return value_; }
+  constexpr const value_type &value() const { return value_; }
+
+private:
+  value_type value_{};
+};
+
+namespace detail {
+
+// options for the value of a fixed<T>
+template <options O> constexpr options fixed_options() {
+  using underlying = typename std::underlying_type<options>::type;
+  return static_cast<options>(
+      static_cast<underlying>(O) |
+      static_cast<underlying>(options::fixed_length_encoding));
+}
+
+// options for the value of a varint<T> - the byte order of a varint does not
+// depend on options::big_endian
+template <options O> constexpr options varint_options() {
+  using underlying = typename std::underlying_type<options>::type;
+  constexpr auto clear = static_cast<underlying>(options::big_endian) |
+                         static_cast<underlying>(options::fixed_length_encoding);
+  return static_cast<options>(static_cast<underlying>(O) & ~clear);
+}
+
+template <typename T>
+typename std::enable_if<is_specialization<T, fixed>::value, void>::type
+type_info(
+    std::vector<uint8_t> &typeids,
+    std::unordered_map<std::string_view, std::size_t> &struct_visitor_map) {
+  typeids.push_back(to_byte<field_type::fixed>());
+  type_info<typename T::value_type>(typeids, struct_visitor_map);
+}
+
+template <typename T>
+typename std::enable_if<is_specialization<T, varint>::value, void>::type
+type_info(
+    std::vector<uint8_t> &typeids,
+    std::unordered_map<std::string_view, std::size_t> &struct_visitor_map) {
+  typeids.push_back(to_byte<field_type::varint>());
+  type_info<typename T::value_type>(typeids, struct_visitor_map);
+}
+
+template <typename T>
+typename std::enable_if<is_bytes<T>::value, void>::type
+type_info(std::vector<uint8_t> &typeids,
+          std::unordered_map<std::string_view, std::size_t> &) {
+  typeids.push_back(to_byte<field_type::bytes>());
+  typeids.push_back(static_cast<uint8_t>(T::size));
+}
+
+template <options O, typename T, typename Container>
+void to_bytes_router(const T &input, Container &bytes, std::size_t &byte_index);
+
+template <options O, typename Container, typename U>
+typename std::enable_if<is_specialization<U, fixed>::value, void>::type
+to_bytes(Container &bytes, std::size_t &byte_index, const U &input) {
+  to_bytes_router<fixed_options<O>()>(input.value(), bytes, byte_index);
+}
+
+template <options O, typename Container, typename U>
+typename std::enable_if<is_specialization<U, varint>::value, void>::type
+to_bytes(Container &bytes, std::size_t &byte_index, const U &input) {
+  to_bytes_router<varint_options<O>()>(input.value(), bytes, byte_index);
+}
+
+template <options O, typename Container, typename U>
+typename std::enable_if<is_bytes<U>::value, void>::type
+to_bytes(Container &bytes, std::size_t &byte_index, const U &input) {
+  constexpr auto N = U::size;
+  const uint64_t value = input.value();
+
+  // low N bytes, in the requested byte order
+  uint8_t buffer[N];
+  for (std::size_t i = 0; i < N; ++i) {
+    const auto byte = static_cast<uint8_t>(value >> (8 * i));
+    if constexpr (big_endian<O>()) {
+      buffer[N - 1 - i] = byte;
+    } else {
+      buffer[i] = byte;
+    }
+  }
+  append(buffer, N, bytes, byte_index);
+}
+
+template <options O, typename T, typename Container>
+void from_bytes_router(T &output, Container &bytes, std::size_t &byte_index,
+                       std::size_t &end_index, std::error_code &error_code);
+
+template <options O, typename U, typename Container>
+typename std::enable_if<is_specialization<U, fixed>::value, bool>::type
+from_bytes(U &output, Container &bytes, std::size_t &current_index,
+           std::size_t &end_index, std::error_code &error_code) {
+  from_bytes_router<fixed_options<O>()>(output.value(), bytes, current_index,
+                                        end_index, error_code);
+  return true;
+}
+
+template <options O, typename U, typename Container>
+typename std::enable_if<is_specialization<U, varint>::value, bool>::type
+from_bytes(U &output, Container &bytes, std::size_t &current_index,
+           std::size_t &end_index, std::error_code &error_code) {
+  from_bytes_router<varint_options<O>()>(output.value(), bytes, current_index,
+                                         end_index, error_code);
+  return true;
+}
+
+template <options O, typename U, typename Container>
+typename std::enable_if<is_bytes<U>::value, bool>::type
+from_bytes(U &output, Container &bytes, std::size_t &current_index,
+           std::size_t &end_index, std::error_code &error_code) {
+  constexpr auto N = U::size;
+
+  if (end_of_input<O>(current_index, end_index)) {
+    // end of input
+
+    // default initialize the value
+    output = U();
+
+    // return true for forward compatibility
+    return true;
+  }
+
+  if (!has_bytes<O>(N, current_index, end_index, error_code)) {
+    return false;
+  }
+
+  uint8_t buffer[N];
+  copy_bytes_from_range(buffer, N, bytes, current_index);
+
+  uint64_t value = 0;
+  for (std::size_t i = 0; i < N; ++i) {
+    const uint64_t byte = big_endian<O>() ? buffer[N - 1 - i] : buffer[i];
+    value |= byte << (8 * i);
+  }
+  output = static_cast<typename U::value_type>(value);
+  return true;
+}
+
+template <options O, typename T, typename Container>
+typename std::enable_if<is_specialization<T, fixed>::value, void>::type
+validate_bytes(Container &bytes, std::size_t &byte_index,
+               std::size_t &end_index, std::error_code &error_code) {
+  validate_router<fixed_options<O>(), typename T::value_type>(
+      bytes, byte_index, end_index, error_code);
+}
+
+template <options O, typename T, typename Container>
+typename std::enable_if<is_specialization<T, varint>::value, void>::type
+validate_bytes(Container &bytes, std::size_t &byte_index,
+               std::size_t &end_index, std::error_code &error_code) {
+  validate_router<varint_options<O>(), typename T::value_type>(
+      bytes, byte_index, end_index, error_code);
+}
+
+template <options O, typename T, typename Container>
+typename std::enable_if<is_bytes<T>::value, void>::type
+validate_bytes(Container &, std::size_t &byte_index, std::size_t &end_index,
+               std::error_code &error_code) {
+  if (end_of_input<O>(byte_index, end_index)) {
+    // end of input
+    return;
+  }
+
+  if (!has_bytes<O>(T::size, byte_index, end_index, error_code)) {
+    return;
+  }
+  byte_index += T::size;
+}
+
+} // namespace detail
+
+} // namespace alpaca
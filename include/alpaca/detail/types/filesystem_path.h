@@ -1,8 +1,10 @@
 #pragma once
 #ifndef ALPACA_EXCLUDE_SUPPORT_STD_FILESYSTEM_PATH
 #include <alpaca/detail/from_bytes.h>
+#include <alpaca/detail/is_wire_trivial.h>
 #include <alpaca/detail/to_bytes.h>
 #include <alpaca/detail/type_info.h>
+#include <alpaca/detail/validate.h>
 #include <filesystem>
 #include <system_error>
 #include <vector>
@@ -26,11 +28,19 @@ template <options O, typename Container>
 void to_bytes(Container &bytes, std::size_t &byte_index,
               const std::filesystem::path &input) {
   // save string length
-  to_bytes_router<O>((size_t_serialized_type)input.native().size(), bytes,
-                     byte_index);
+  to_bytes_size<O>(bytes, byte_index, input.native().size());
 
-  for (const auto &c : input.native()) {
-    to_bytes<O>(bytes, byte_index, c);
+  using CharType = std::filesystem::path::value_type;
+  if constexpr (is_wire_trivial<CharType, O>::value) {
+    // characters are written as is - copy them in one go
+    if (!input.empty()) {
+      append(reinterpret_cast<const uint8_t *>(input.native().data()),
+             input.native().size() * sizeof(CharType), bytes, byte_index);
+    }
+  } else {
+    for (const auto &c : input.native()) {
+      to_bytes<O>(bytes, byte_index, c);
+    }
   }
 }
 
@@ -39,15 +49,15 @@ bool from_bytes(std::filesystem::path &value, Container &bytes,
                 std::size_t &current_index, std::size_t &end_index,
                 std::error_code &error_code) {
 
-  if (current_index >= end_index) {
+  if (end_of_input<O>(current_index, end_index)) {
     // end of input
     // return true for forward compatibility
     return true;
   }
 
   // current byte is the length of the string
-  size_t_serialized_type size = 0;
-  detail::from_bytes<O, size_t_serialized_type>(size, bytes, current_index,
+  serialized_size_type<O> size = 0;
+  detail::from_bytes<O, serialized_size_type<O>>(size, bytes, current_index,
                                                 end_index, error_code);
 
   if (size > end_index - current_index) {
@@ -58,22 +68,41 @@ bool from_bytes(std::filesystem::path &value, Container &bytes,
     return false;
   }
 
-  // read `size` bytes and save to value
   std::filesystem::path::string_type buff;
   using CharType = std::filesystem::path::value_type;
 
-  buff.reserve(size * sizeof(CharType));
-
-  for (std::size_t i = 0; i < size; ++i) {
-    CharType character{};
-    from_bytes<O>(character, bytes, current_index, end_index, error_code);
-    buff += character;
+  const std::size_t num_bytes =
+      static_cast<std::size_t>(size) * sizeof(CharType);
+  if (is_wire_trivial<CharType, O>::value &&
+      num_bytes <= end_index - current_index) {
+    // characters are byte-identical on the wire - copy them in one go
+    if (size > 0) {
+      buff.resize(size);
+      copy_bytes_from_range(&buff[0], num_bytes, bytes, current_index);
+    }
+  } else {
+    // read `size` characters and save to value
+    buff.reserve(size);
+    for (std::size_t i = 0; i < size; ++i) {
+      CharType character{};
+      from_bytes<O>(character, bytes, current_index, end_index, error_code);
+      buff += character;
+    }
   }
 
   value = std::move(buff);
   return true;
 }
 
+template <options O, typename T, typename Container>
+typename std::enable_if<std::is_same<T, std::filesystem::path>::value,
+                        void>::type
+validate_bytes(Container &bytes, std::size_t &byte_index,
+               std::size_t &end_index, std::error_code &error_code) {
+  validate_sequence<O, typename T::value_type>(bytes, byte_index, end_index,
+                                               error_code);
+}
+
 } // namespace detail
 
 } // namespace alpaca
@@ -46,6 +46,14 @@ bool from_bytes(glm::vec<L, T, Q> &output, Container &bytes, std::size_t &byte_i
     return true;
 }
 
+template <options O, typename T, typename Container>
+typename std::enable_if<is_glm_vec<T>::value, void>::type
+validate_bytes(Container &bytes, std::size_t &byte_index,
+               std::size_t &end_index, std::error_code &error_code) {
+  validate_bytes<O, std::array<typename T::T, T::L>>(bytes, byte_index,
+                                                     end_index, error_code);
+}
+
 }  // namespace detail
 
 }  // namespace alpaca
@@ -2,6 +2,7 @@
 #ifndef ALPACA_EXCLUDE_SUPPORT_STD_LIST
 #include <alpaca/detail/to_bytes.h>
 #include <alpaca/detail/type_info.h>
+#include <alpaca/detail/validate.h>
 #include <list>
 #include <system_error>
 
@@ -26,7 +27,7 @@ template <options O, typename T, typename Container>
 void to_bytes_from_list_type(const T &input, Container &bytes,
                              std::size_t &byte_index) {
   // save list size
-  to_bytes_router<O, size_t_serialized_type>(input.size(), bytes, byte_index);
+  to_bytes_size<O>(bytes, byte_index, input.size());
 
   // value of each element in list
   for (const auto &v : input) {
@@ -50,15 +51,15 @@ bool from_bytes_to_list(std::list<T> &value, Container &bytes,
                         std::size_t &current_index, std::size_t &end_index,
                         std::error_code &error_code) {
 
-  if (current_index >= end_index) {
+  if (end_of_input<O>(current_index, end_index)) {
     // end of input
     // return true for forward compatibility
     return true;
   }
 
   // current byte is the size of the vector
-  size_t_serialized_type size = 0;
-  detail::from_bytes<O, size_t_serialized_type>(size, bytes, current_index, end_index,
+  serialized_size_type<O> size = 0;
+  detail::from_bytes<O, serialized_size_type<O>>(size, bytes, current_index, end_index,
                                      error_code);
 
   if (size > end_index - current_index) {
@@ -69,15 +70,16 @@ bool from_bytes_to_list(std::list<T> &value, Container &bytes,
     return false;
   }
 
-  // read `size` bytes and save to value
-  for (std::size_t i = 0; i < size; ++i) {
-    T v{};
-    from_bytes_router<O>(v, bytes, current_index, end_index, error_code);
+  // read `size` elements into value, reusing the existing nodes
+  // if value is not empty
+  value.resize(size);
+  for (auto it = value.begin(); it != value.end(); ++it) {
+    from_bytes_router<O>(*it, bytes, current_index, end_index, error_code);
     if (error_code) {
       // something went wrong
+      value.erase(it, value.end());
       return false;
     }
-    value.push_back(v);
   }
 
   return true;
@@ -90,6 +92,14 @@ bool from_bytes(std::list<T> &output, Container &bytes, std::size_t &byte_index,
                                error_code);
 }
 
+template <options O, typename T, typename Container>
+typename std::enable_if<is_specialization<T, std::list>::value, void>::type
+validate_bytes(Container &bytes, std::size_t &byte_index,
+               std::size_t &end_index, std::error_code &error_code) {
+  validate_sequence<O, typename T::value_type>(bytes, byte_index, end_index,
+                                               error_code);
+}
+
 } // namespace detail
 
 } // namespace alpaca
@@ -1,6 +1,9 @@
 #pragma once
+#include <alpaca/detail/to_bytes.h>
 #include <alpaca/detail/type_info.h>
+#include <alpaca/detail/validate.h>
 #include <alpaca/detail/variable_length_encoding.h>
+#include <iterator>
 
 #ifndef ALPACA_EXCLUDE_SUPPORT_STD_MAP
 #include <map>
@@ -51,7 +54,7 @@ template <options O, typename T, typename Container>
 void to_bytes_from_map_type(const T &input, Container &bytes,
                             std::size_t &byte_index) {
   // save map size
-  to_bytes_router<O, size_t_serialized_type, Container>((size_t_serialized_type) input.size(), bytes, byte_index);
+  to_bytes_size<O>(bytes, byte_index, input.size());
 
   // save key,value pairs in map
   for (const auto &[key, value] : input) {
@@ -80,12 +83,13 @@ template <options O, typename T, typename Container>
 void from_bytes_router(T &output, Container &bytes, std::size_t &byte_index,
                        std::size_t &end_index, std::error_code &error_code);
 
-template <options O, typename T, typename Container>
+// sorted -> map is an ordered container, serialized in ascending key order
+template <options O, bool sorted, typename T, typename Container>
 void from_bytes_to_map(T &map, Container &bytes, std::size_t &current_index,
                        std::size_t &end_index, std::error_code &error_code) {
   // current byte is the size of the map
-  size_t_serialized_type size = 0;
-  detail::from_bytes<O, size_t_serialized_type>(size, bytes, current_index, end_index,
+  serialized_size_type<O> size = 0;
+  detail::from_bytes<O, serialized_size_type<O>>(size, bytes, current_index, end_index,
                                      error_code);
 
   if (size > end_index - current_index) {
@@ -96,15 +100,55 @@ void from_bytes_to_map(T &map, Container &bytes, std::size_t &current_index,
     return;
   }
 
-  // read `size` bytes and save to value
-  for (std::size_t i = 0; i < size; ++i) {
-    typename T::key_type key{};
-    from_bytes_router<O>(key, bytes, current_index, end_index, error_code);
+  // take over the current elements so that their nodes can be reused
+  T spare;
+  spare.swap(map);
 
-    typename T::mapped_type value{};
-    from_bytes_router<O>(value, bytes, current_index, end_index, error_code);
+  if constexpr (!sorted) {
+    // allocate the buckets once instead of rehashing while inserting
+    map.reserve(size);
+  }
 
-    map.insert(std::make_pair(key, value));
+  // read `size` key,value pairs and save to map
+  //
+  // keys of ordered maps arrive in ascending order, so each one is inserted
+  // at the end, which takes amortized constant time with a hint
+  for (std::size_t i = 0; i < size; ++i) {
+    [[maybe_unused]] typename T::iterator it;
+    if (!spare.empty()) {
+      // decode into a reused node
+      auto node = spare.extract(spare.begin());
+      from_bytes_router<O>(node.key(), bytes, current_index, end_index,
+                           error_code);
+      from_bytes_router<O>(node.mapped(), bytes, current_index, end_index,
+                           error_code);
+      if (error_code) {
+        // something went wrong
+        return;
+      }
+      it = map.insert(map.end(), std::move(node));
+    } else {
+      typename T::key_type key{};
+      from_bytes_router<O>(key, bytes, current_index, end_index, error_code);
+
+      typename T::mapped_type value{};
+      from_bytes_router<O>(value, bytes, current_index, end_index, error_code);
+      if (error_code) {
+        // something went wrong
+        return;
+      }
+      it = map.emplace_hint(map.end(), std::move(key), std::move(value));
+    }
+
+    if constexpr (sorted && require_sorted_keys<O>()) {
+      if (map.size() != i + 1 || std::next(it) != map.end()) {
+        // key is not greater than the previous key
+        error_code = std::make_error_code(std::errc::illegal_byte_sequence);
+
+        // stop here
+        return;
+      }
+    }
   }
 }
 
@@ -114,13 +158,13 @@ bool from_bytes(std::map<K, V> &output, Container &bytes,
                 std::size_t &byte_index, std::size_t &end_index,
                 std::error_code &error_code) {
 
-  if (byte_index >= end_index) {
+  if (end_of_input<O>(byte_index, end_index)) {
     // end of input
     // return true for forward compatibility
     return true;
   }
 
-  from_bytes_to_map<O>(output, bytes, byte_index, end_index, error_code);
+  from_bytes_to_map<O, true>(output, bytes, byte_index, end_index, error_code);
   return true;
 }
 #endif
@@ -131,17 +175,71 @@ bool from_bytes(std::unordered_map<K, V> &output, Container &bytes,
                 std::size_t &byte_index, std::size_t &end_index,
                 std::error_code &error_code) {
 
-  if (byte_index >= end_index) {
+  if (end_of_input<O>(byte_index, end_index)) {
     // end of input
     // return true for forward compatibility
     return true;
   }
 
-  from_bytes_to_map<O>(output, bytes, byte_index, end_index, error_code);
+  from_bytes_to_map<O, false>(output, bytes, byte_index, end_index, error_code);
   return true;
 }
 #endif
 
+template <options O, typename T, typename Container>
+void validate_map(Container &bytes, std::size_t &current_index,
+                  std::size_t &end_index, std::error_code &error_code) {
+  if (end_of_input<O>(current_index, end_index)) {
+    // end of input
+    return;
+  }
+
+  const auto size =
+      validate_size<O>(bytes, current_index, end_index, error_code);
+  if (error_code) {
+    return;
+  }
+
+  if (size > end_index - current_index) {
+    // size is greater than the number of bytes remaining
+    error_code = std::make_error_code(std::errc::value_too_large);
+    return;
+  }
+
+  // `size` key,value pairs
+  for (std::size_t i = 0; i < size; ++i) {
+    validate_router<O, typename T::key_type>(bytes, current_index, end_index,
+                                             error_code);
+    if (error_code) {
+      return;
+    }
+    validate_router<O, typename T::mapped_type>(bytes, current_index,
+                                                end_index, error_code);
+    if (error_code) {
+      return;
+    }
+  }
+}
+
+#ifndef ALPACA_EXCLUDE_SUPPORT_STD_MAP
+template <options O, typename T, typename Container>
+typename std::enable_if<is_specialization<T, std::map>::value, void>::type
+validate_bytes(Container &bytes, std::size_t &byte_index,
+               std::size_t &end_index, std::error_code &error_code) {
+  validate_map<O, T>(bytes, byte_index, end_index, error_code);
+}
+#endif
+
+#ifndef ALPACA_EXCLUDE_SUPPORT_STD_UNORDERED_MAP
+template <options O, typename T, typename Container>
+typename std::enable_if<is_specialization<T, std::unordered_map>::value,
+                        void>::type
+validate_bytes(Container &bytes, std::size_t &byte_index,
+               std::size_t &end_index, std::error_code &error_code) {
+  validate_map<O, T>(bytes, byte_index, end_index, error_code);
+}
+#endif
+
 } // namespace detail
 
 } // namespace alpaca
\ No newline at end of file
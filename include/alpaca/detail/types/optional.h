@@ -1,6 +1,7 @@
 #pragma once
 #ifndef ALPACA_EXCLUDE_SUPPORT_STD_OPTIONAL
 #include <alpaca/detail/type_info.h>
+#include <alpaca/detail/validate.h>
 #include <optional>
 #include <system_error>
 #include <vector>
@@ -45,12 +46,16 @@ bool from_bytes(std::optional<T> &output, Container &bytes,
                 std::size_t &byte_index, std::size_t &end_index,
                 std::error_code &error_code) {
 
-  if (byte_index >= end_index) {
+  if (end_of_input<O>(byte_index, end_index)) {
     // end of input
     // return true for forward compatibility
     return true;
   }
 
+  if (!has_bytes<O>(1, byte_index, end_index, error_code)) {
+    return false;
+  }
+
   auto current_byte = bytes[byte_index];
 
   // check if has_value has a legal value of either 0 or 1
@@ -66,15 +71,44 @@ bool from_bytes(std::optional<T> &output, Container &bytes,
   bool has_value = static_cast<bool>(bytes[byte_index++]);
 
   if (has_value) {
-    // read value of optional
-    T value;
-    from_bytes_router<O>(value, bytes, byte_index, end_index, error_code);
-    output = value;
+    // read value of optional, into the current value if there is one
+    if (!output.has_value()) {
+      output.emplace();
+    }
+    from_bytes_router<O>(*output, bytes, byte_index, end_index, error_code);
+  } else {
+    output.reset();
   }
 
   return true;
 }
 
+template <options O, typename T, typename Container>
+typename std::enable_if<is_specialization<T, std::optional>::value, void>::type
+validate_bytes(Container &bytes, std::size_t &byte_index,
+               std::size_t &end_index, std::error_code &error_code) {
+  if (end_of_input<O>(byte_index, end_index)) {
+    // end of input
+    return;
+  }
+
+  if (!has_bytes<O>(1, byte_index, end_index, error_code)) {
+    return;
+  }
+
+  // has_value byte must be either 0 or 1
+  const auto has_value = static_cast<uint8_t>(bytes[byte_index++]);
+  if (has_value > 1) {
+    error_code = std::make_error_code(std::errc::illegal_byte_sequence);
+    return;
+  }
+
+  if (has_value) {
+    validate_router<O, typename T::value_type>(bytes, byte_index, end_index,
+                                               error_code);
+  }
+}
+
 } // namespace detail
 
 } // namespace alpaca
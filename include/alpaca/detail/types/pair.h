@@ -1,6 +1,7 @@
 #pragma once
 #ifndef ALPACA_EXCLUDE_SUPPORT_STD_PAIR
 #include <alpaca/detail/type_info.h>
+#include <alpaca/detail/validate.h>
 #include <system_error>
 #include <utility>
 #include <vector>
@@ -42,7 +43,7 @@ bool from_bytes(std::pair<T, U> &output, Container &bytes,
                 std::size_t &byte_index, std::size_t &end_index,
                 std::error_code &error_code) {
 
-  if (byte_index >= end_index) {
+  if (end_of_input<O>(byte_index, end_index)) {
     // end of input
     // return true for forward compatibility
     return true;
@@ -54,6 +55,18 @@ bool from_bytes(std::pair<T, U> &output, Container &bytes,
   return true;
 }
 
+template <options O, typename T, typename Container>
+typename std::enable_if<is_specialization<T, std::pair>::value, void>::type
+validate_bytes(Container &bytes, std::size_t &byte_index,
+               std::size_t &end_index, std::error_code &error_code) {
+  validate_router<O, typename T::first_type>(bytes, byte_index, end_index,
+                                             error_code);
+  if (!error_code) {
+    validate_router<O, typename T::second_type>(bytes, byte_index, end_index,
+                                                error_code);
+  }
+}
+
 } // namespace detail
 
 } // namespace alpaca
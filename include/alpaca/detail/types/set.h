@@ -1,6 +1,8 @@
 #pragma once
 #include <alpaca/detail/to_bytes.h>
 #include <alpaca/detail/type_info.h>
+#include <alpaca/detail/validate.h>
+#include <iterator>
 
 #ifndef ALPACA_EXCLUDE_SUPPORT_STD_SET
 #include <set>
@@ -50,7 +52,7 @@ template <options O, typename T, typename Container>
 void to_bytes_from_set_type(const T &input, Container &bytes,
                             std::size_t &byte_index) {
   // save set size
-  to_bytes_router<O, size_t_serialized_type, Container>((size_t_serialized_type) input.size(), bytes, byte_index);
+  to_bytes_size<O>(bytes, byte_index, input.size());
 
   // save values in set
   for (const auto &value : input) {
@@ -78,12 +80,13 @@ template <options O, typename T, typename Container>
 void from_bytes_router(T &output, Container &bytes, std::size_t &byte_index,
                        std::size_t &end_index, std::error_code &error_code);
 
-template <options O, typename T, typename Container>
+// sorted -> set is an ordered container, serialized in ascending order
+template <options O, bool sorted, typename T, typename Container>
 void from_bytes_to_set(T &set, Container &bytes, std::size_t &current_index,
                        std::size_t &end_index, std::error_code &error_code) {
   // current byte is the size of the set
-  size_t_serialized_type size = 0;
-  detail::from_bytes<O, size_t_serialized_type>(size, bytes, current_index, end_index,
+  serialized_size_type<O> size = 0;
+  detail::from_bytes<O, serialized_size_type<O>>(size, bytes, current_index, end_index,
                                      error_code);
 
   if (size > end_index - current_index) {
@@ -94,11 +97,50 @@ void from_bytes_to_set(T &set, Container &bytes, std::size_t &current_index,
     return;
   }
 
-  // read `size` bytes and save to value
+  // take over the current elements so that their nodes can be reused
+  T spare;
+  spare.swap(set);
+
+  if constexpr (!sorted) {
+    // allocate the buckets once instead of rehashing while inserting
+    set.reserve(size);
+  }
+
+  // read `size` values and save to set
+  //
+  // values of ordered sets arrive in ascending order, so each one is
+  // inserted at the end, which takes amortized constant time with a hint
   for (std::size_t i = 0; i < size; ++i) {
-    typename T::value_type value{};
-    from_bytes_router<O>(value, bytes, current_index, end_index, error_code);
-    set.insert(value);
+    [[maybe_unused]] typename T::iterator it;
+    if (!spare.empty()) {
+      // decode into a reused node
+      auto node = spare.extract(spare.begin());
+      from_bytes_router<O>(node.value(), bytes, current_index, end_index,
+                           error_code);
+      if (error_code) {
+        // something went wrong
+        return;
+      }
+      it = set.insert(set.end(), std::move(node));
+    } else {
+      typename T::value_type value{};
+      from_bytes_router<O>(value, bytes, current_index, end_index, error_code);
+      if (error_code) {
+        // something went wrong
+        return;
+      }
+      it = set.insert(set.end(), std::move(value));
+    }
+
+    if constexpr (sorted && require_sorted_keys<O>()) {
+      if (set.size() != i + 1 || std::next(it) != set.end()) {
+        // value is not greater than the previous value
+        error_code = std::make_error_code(std::errc::illegal_byte_sequence);
+
+        // stop here
+        return;
+      }
+    }
   }
 }
 
@@ -107,13 +149,13 @@ template <options O, typename T, typename Container>
 bool from_bytes(std::set<T> &output, Container &bytes, std::size_t &byte_index,
                 std::size_t &end_index, std::error_code &error_code) {
 
-  if (byte_index >= end_index) {
+  if (end_of_input<O>(byte_index, end_index)) {
     // end of input
     // return true for forward compatibility
     return true;
   }
 
-  from_bytes_to_set<O>(output, bytes, byte_index, end_index, error_code);
+  from_bytes_to_set<O, true>(output, bytes, byte_index, end_index, error_code);
   return true;
 }
 #endif
@@ -124,17 +166,38 @@ bool from_bytes(std::unordered_set<T> &output, Container &bytes,
                 std::size_t &byte_index, std::size_t &end_index,
                 std::error_code &error_code) {
 
-  if (byte_index >= end_index) {
+  if (end_of_input<O>(byte_index, end_index)) {
     // end of input
     // return true for forward compatibility
     return true;
   }
 
-  from_bytes_to_set<O>(output, bytes, byte_index, end_index, error_code);
+  from_bytes_to_set<O, false>(output, bytes, byte_index, end_index, error_code);
   return true;
 }
 #endif
 
+#ifndef ALPACA_EXCLUDE_SUPPORT_STD_SET
+template <options O, typename T, typename Container>
+typename std::enable_if<is_specialization<T, std::set>::value, void>::type
+validate_bytes(Container &bytes, std::size_t &byte_index,
+               std::size_t &end_index, std::error_code &error_code) {
+  validate_sequence<O, typename T::value_type>(bytes, byte_index, end_index,
+                                               error_code);
+}
+#endif
+
+#ifndef ALPACA_EXCLUDE_SUPPORT_STD_UNORDERED_SET
+template <options O, typename T, typename Container>
+typename std::enable_if<is_specialization<T, std::unordered_set>::value,
+                        void>::type
+validate_bytes(Container &bytes, std::size_t &byte_index,
+               std::size_t &end_index, std::error_code &error_code) {
+  validate_sequence<O, typename T::value_type>(bytes, byte_index, end_index,
+                                               error_code);
+}
+#endif
+
 } // namespace detail
 
 } // namespace alpaca
\ No newline at end of file
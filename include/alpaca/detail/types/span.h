@@ -0,0 +1,112 @@
+#pragma once
+#ifndef ALPACA_EXCLUDE_SUPPORT_STD_SPAN
+#if __has_include(<span>)
+#include <span>
+#endif
+#ifdef __cpp_lib_span
+#include <alpaca/detail/from_bytes.h>
+#include <alpaca/detail/is_wire_trivial.h>
+#include <alpaca/detail/to_bytes.h>
+#include <alpaca/detail/type_info.h>
+#include <alpaca/detail/validate.h>
+#include <system_error>
+#include <vector>
+
+namespace alpaca {
+
+namespace detail {
+
+// is_specialization can not match the extent of a span
+template <typename T> struct is_span : std::false_type {};
+
+template <typename T, std::size_t Extent>
+struct is_span<std::span<T, Extent>> : std::true_type {};
+
+// same wire format, and type information, as std::vector
+template <typename T>
+typename std::enable_if<is_span<T>::value, void>::type type_info(
+    std::vector<uint8_t> &typeids,
+    std::unordered_map<std::string_view, std::size_t> &struct_visitor_map) {
+  typeids.push_back(to_byte<field_type::vector>());
+  using value_type = typename T::value_type;
+  type_info<value_type>(typeids, struct_visitor_map);
+}
+
+template <options O, typename T, typename Container>
+void to_bytes_router(const T &input, Container &bytes, std::size_t &byte_index);
+
+template <options O, typename Container, typename T, std::size_t Extent>
+void to_bytes(Container &bytes, std::size_t &byte_index,
+              const std::span<T, Extent> &input) {
+  // save span size
+  to_bytes_size<O>(bytes, byte_index, input.size());
+
+  using value_type = std::remove_cv_t<T>;
+  if constexpr (is_wire_trivial<value_type, O>::value) {
+    // elements are byte-identical on the wire - copy them in one go
+    if (!input.empty()) {
+      append(reinterpret_cast<const uint8_t *>(input.data()),
+             input.size() * sizeof(value_type), bytes, byte_index);
+    }
+  } else {
+    for (const auto &v : input) {
+      to_bytes_router<O>(v, bytes, byte_index);
+    }
+  }
+}
+
+// points into the input instead of copying the elements
+// the input must outlive value
+template <options O, typename Container, typename T>
+bool from_bytes(std::span<const T> &value, Container &bytes,
+                std::size_t &current_index, std::size_t &end_index,
+                std::error_code &error_code) {
+  static_assert(is_wire_trivial<T, O>::value,
+                "std::span requires elements that are byte-identical on the "
+                "wire");
+
+  value = {};
+  if (end_of_input<O>(current_index, end_index)) {
+    // end of input
+    // return true for forward compatibility
+    return true;
+  }
+
+  // current byte is the size of the span
+  serialized_size_type<O> size = 0;
+  detail::from_bytes<O, serialized_size_type<O>>(size, bytes, current_index,
+                                                end_index, error_code);
+
+  // divide, rather than multiply, so that a large size cannot overflow
+  if (size > (end_index - current_index) / sizeof(T)) {
+    // size is greater than the number of bytes remaining
+    error_code = std::make_error_code(std::errc::value_too_large);
+
+    // stop here
+    return false;
+  }
+
+  if (size > 0) {
+    const T *data = borrow_from_range<T>(bytes, current_index, size, error_code);
+    if (error_code) {
+      return false;
+    }
+    value = std::span<const T>(data, size);
+  }
+
+  return true;
+}
+
+template <options O, typename T, typename Container>
+typename std::enable_if<is_span<T>::value, void>::type
+validate_bytes(Container &bytes, std::size_t &current_index,
+               std::size_t &end_index, std::error_code &error_code) {
+  validate_borrowed_range<O, std::remove_const_t<typename T::element_type>>(
+      bytes, current_index, end_index, error_code);
+}
+
+} // namespace detail
+
+} // namespace alpaca
+#endif
+#endif
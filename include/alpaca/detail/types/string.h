@@ -1,8 +1,10 @@
 #pragma once
 #ifndef ALPACA_EXCLUDE_SUPPORT_STD_STRING
 #include <alpaca/detail/from_bytes.h>
+#include <alpaca/detail/is_wire_trivial.h>
 #include <alpaca/detail/to_bytes.h>
 #include <alpaca/detail/type_info.h>
+#include <alpaca/detail/validate.h>
 #include <string>
 #include <system_error>
 #include <vector>
@@ -26,31 +28,38 @@ template <options O, typename Container, typename CharType>
 void to_bytes(Container &bytes, std::size_t &byte_index,
               const std::basic_string<CharType> &input) {
   // save string length
-  to_bytes_router<O>((size_t_serialized_type) input.size(), bytes, byte_index);
-
-  for (const auto &c : input) {
-    to_bytes<O>(bytes, byte_index, c);
+  to_bytes_size<O>(bytes, byte_index, input.size());
+
+  if constexpr (is_wire_trivial<CharType, O>::value) {
+    // characters are written as is - copy them in one go
+    if (!input.empty()) {
+      append(reinterpret_cast<const uint8_t *>(input.data()),
+             input.size() * sizeof(CharType), bytes, byte_index);
+    }
+  } else {
+    for (const auto &c : input) {
+      to_bytes<O>(bytes, byte_index, c);
+    }
   }
 }
 
 template <options O, typename Container, typename CharType>
-typename std::enable_if<!std::is_same_v<Container, std::ifstream>, bool>::type
-from_bytes(std::basic_string<CharType> &value, Container &bytes,
-           std::size_t &current_index, std::size_t &end_index,
-           std::error_code &error_code) {
+bool from_bytes(std::basic_string<CharType> &value, Container &bytes,
+                std::size_t &current_index, std::size_t &end_index,
+                std::error_code &error_code) {
   // clear out the value - this ensures that value will be only what is read
   // from the stream, and not any previous data that may have been set during
   // the construction of the containing object T().
   value.clear();
-  if (current_index >= end_index) {
+  if (end_of_input<O>(current_index, end_index)) {
     // end of input
     // return true for forward compatibility
     return true;
   }
 
   // current byte is the length of the string
-  size_t_serialized_type size = 0;
-  detail::from_bytes<O, size_t_serialized_type>(size, bytes, current_index, end_index,
+  serialized_size_type<O> size = 0;
+  detail::from_bytes<O, serialized_size_type<O>>(size, bytes, current_index, end_index,
                                      error_code);
 
   if (size > end_index - current_index) {
@@ -61,8 +70,21 @@ from_bytes(std::basic_string<CharType> &value, Container &bytes,
     return false;
   }
 
-  // read `size` bytes and save to value
-  value.reserve(size * sizeof(CharType));
+  if constexpr (is_wire_trivial<CharType, O>::value) {
+    // characters are byte-identical on the wire - copy them in one go
+    const std::size_t num_bytes =
+        static_cast<std::size_t>(size) * sizeof(CharType);
+    if (num_bytes <= end_index - current_index) {
+      if (size > 0) {
+        value.resize(size);
+        copy_bytes_from_range(&value[0], num_bytes, bytes, current_index);
+      }
+      return true;
+    }
+  }
+
+  // read `size` characters and save to value
+  value.reserve(size);
   for (std::size_t i = 0; i < size; ++i) {
     CharType character{};
     from_bytes<O>(character, bytes, current_index, end_index, error_code);
@@ -72,44 +94,13 @@ from_bytes(std::basic_string<CharType> &value, Container &bytes,
   return true;
 }
 
-// ifstream version
-template <options O, typename Container, typename CharType>
-typename std::enable_if<std::is_same_v<Container, std::ifstream>, bool>::type
-from_bytes(std::basic_string<CharType> &value, Container &bytes,
-           std::size_t &current_index, std::size_t &end_index,
-           std::error_code &error_code) {
-  // clear out the value - this ensures that value will be only what is read
-  // from the stream, and not any previous data that may have been set during
-  // the construction of the containing object T().
-  value.clear();
-  if (current_index >= end_index) {
-    // end of input
-    // return true for forward compatibility
-    return true;
-  }
-
-  // current byte is the length of the string
-  size_t_serialized_type size = 0;
-  detail::from_bytes<O, size_t_serialized_type>(size, bytes, current_index, end_index,
-                                     error_code);
-
-  if (size > end_index - current_index) {
-    // size is greater than the number of bytes remaining
-    error_code = std::make_error_code(std::errc::value_too_large);
-
-    // stop here
-    return false;
-  }
-
-  // read `size` bytes and save to value
-  value.reserve(size * sizeof(CharType));
-  for (std::size_t i = 0; i < size; ++i) {
-    CharType character;
-    from_bytes<O>(character, bytes, current_index, end_index, error_code);
-    value += character;
-  }
-
-  return true;
+template <options O, typename T, typename Container>
+typename std::enable_if<is_specialization<T, std::basic_string>::value,
+                        void>::type
+validate_bytes(Container &bytes, std::size_t &byte_index,
+               std::size_t &end_index, std::error_code &error_code) {
+  validate_sequence<O, typename T::value_type>(bytes, byte_index, end_index,
+                                               error_code);
 }
 
 } // namespace detail
@@ -0,0 +1,102 @@
+#pragma once
+#ifndef ALPACA_EXCLUDE_SUPPORT_STD_STRING_VIEW
+#include <alpaca/detail/from_bytes.h>
+#include <alpaca/detail/is_wire_trivial.h>
+#include <alpaca/detail/to_bytes.h>
+#include <alpaca/detail/type_info.h>
+#include <alpaca/detail/validate.h>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+namespace alpaca {
+
+namespace detail {
+
+// same wire format, and type information, as std::basic_string
+template <typename T>
+typename std::enable_if<is_specialization<T, std::basic_string_view>::value,
+                        void>::type
+type_info(std::vector<uint8_t> &typeids,
+          std::unordered_map<std::string_view, std::size_t> &) {
+  typeids.push_back(to_byte<field_type::string>());
+}
+
+template <options O, typename T, typename Container>
+void to_bytes_router(const T &input, Container &bytes, std::size_t &byte_index);
+
+template <options O, typename Container, typename CharType>
+void to_bytes(Container &bytes, std::size_t &byte_index,
+              const std::basic_string_view<CharType> &input) {
+  // save string length
+  to_bytes_size<O>(bytes, byte_index, input.size());
+
+  if constexpr (is_wire_trivial<CharType, O>::value) {
+    // characters are written as is - copy them in one go
+    if (!input.empty()) {
+      append(reinterpret_cast<const uint8_t *>(input.data()),
+             input.size() * sizeof(CharType), bytes, byte_index);
+    }
+  } else {
+    for (const auto &c : input) {
+      to_bytes<O>(bytes, byte_index, c);
+    }
+  }
+}
+
+// points into the input instead of copying the characters
+// the input must outlive value
+template <options O, typename Container, typename CharType>
+bool from_bytes(std::basic_string_view<CharType> &value, Container &bytes,
+                std::size_t &current_index, std::size_t &end_index,
+                std::error_code &error_code) {
+  static_assert(is_wire_trivial<CharType, O>::value,
+                "std::basic_string_view requires characters that are "
+                "byte-identical on the wire");
+
+  value = {};
+  if (end_of_input<O>(current_index, end_index)) {
+    // end of input
+    // return true for forward compatibility
+    return true;
+  }
+
+  // current byte is the length of the string
+  serialized_size_type<O> size = 0;
+  detail::from_bytes<O, serialized_size_type<O>>(size, bytes, current_index,
+                                                end_index, error_code);
+
+  // divide, rather than multiply, so that a large size cannot overflow
+  if (size > (end_index - current_index) / sizeof(CharType)) {
+    // size is greater than the number of bytes remaining
+    error_code = std::make_error_code(std::errc::value_too_large);
+
+    // stop here
+    return false;
+  }
+
+  if (size > 0) {
+    const CharType *data =
+        borrow_from_range<CharType>(bytes, current_index, size, error_code);
+    if (error_code) {
+      return false;
+    }
+    value = std::basic_string_view<CharType>(data, size);
+  }
+
+  return true;
+}
+
+template <options O, typename T, typename Container>
+typename std::enable_if<is_specialization<T, std::basic_string_view>::value,
+                        void>::type
+validate_bytes(Container &bytes, std::size_t &current_index,
+               std::size_t &end_index, std::error_code &error_code) {
+  validate_borrowed_range<O, typename T::value_type>(bytes, current_index,
+                                                     end_index, error_code);
+}
+
+} // namespace detail
+
+} // namespace alpaca
+#endif
@@ -1,6 +1,7 @@
 #pragma once
 #ifndef ALPACA_EXCLUDE_SUPPORT_STD_TUPLE
 #include <alpaca/detail/type_info.h>
+#include <alpaca/detail/validate.h>
 #include <system_error>
 #include <tuple>
 #include <vector>
@@ -88,7 +89,7 @@ bool from_bytes(std::tuple<T...> &output, Container &bytes,
                 std::size_t &byte_index, std::size_t &end_index,
                 std::error_code &error_code) {
 
-  if (byte_index >= end_index) {
+  if (end_of_input<O>(byte_index, end_index)) {
     // end of input
     // return true for forward compatibility
     return true;
@@ -98,6 +99,29 @@ bool from_bytes(std::tuple<T...> &output, Container &bytes,
   return true;
 }
 
+template <options O, typename T, typename Container, std::size_t index>
+void validate_tuple_value(Container &bytes, std::size_t &current_index,
+                          std::size_t &end_index,
+                          std::error_code &error_code) {
+  constexpr auto max_index = std::tuple_size<T>::value;
+  if constexpr (index < max_index) {
+    validate_router<O, typename std::tuple_element<index, T>::type>(
+        bytes, current_index, end_index, error_code);
+    if (!error_code) {
+      validate_tuple_value<O, T, Container, index + 1>(bytes, current_index,
+                                                       end_index, error_code);
+    }
+  }
+}
+
+template <options O, typename T, typename Container>
+typename std::enable_if<is_specialization<T, std::tuple>::value, void>::type
+validate_bytes(Container &bytes, std::size_t &byte_index,
+               std::size_t &end_index, std::error_code &error_code) {
+  validate_tuple_value<O, T, Container, 0>(bytes, byte_index, end_index,
+                                           error_code);
+}
+
 } // namespace detail
 
 } // namespace alpaca
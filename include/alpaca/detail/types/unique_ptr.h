@@ -2,6 +2,7 @@
 #ifndef ALPACA_EXCLUDE_SUPPORT_STD_UNIQUE_PTR
 #include <alpaca/detail/to_bytes.h>
 #include <alpaca/detail/type_info.h>
+#include <alpaca/detail/validate.h>
 #include <memory>
 #include <system_error>
 #include <vector>
@@ -50,12 +51,16 @@ bool from_bytes(std::unique_ptr<T> &output, Container &bytes,
                 std::size_t &byte_index, std::size_t &end_index,
                 std::error_code &error_code) {
 
-  if (byte_index >= end_index) {
+  if (end_of_input<O>(byte_index, end_index)) {
     // end of input
     // return true for forward compatibility
     return true;
   }
 
+  if (!has_bytes<O>(1, byte_index, end_index, error_code)) {
+    return false;
+  }
+
   auto current_byte = bytes[byte_index];
 
   // check if has_value has a legal value of either 0 or 1
@@ -71,10 +76,11 @@ bool from_bytes(std::unique_ptr<T> &output, Container &bytes,
   bool has_value = static_cast<bool>(bytes[byte_index++]);
 
   if (has_value) {
-    // read value of unique_ptr
-    T value{};
-    from_bytes_router<O>(value, bytes, byte_index, end_index, error_code);
-    output = std::unique_ptr<T>(new T{std::move(value)});
+    // read value of unique_ptr, into the current pointee if there is one
+    if (!output) {
+      output = std::unique_ptr<T>(new T{});
+    }
+    from_bytes_router<O>(*output, bytes, byte_index, end_index, error_code);
   } else {
     output = nullptr;
   }
@@ -82,6 +88,33 @@ bool from_bytes(std::unique_ptr<T> &output, Container &bytes,
   return true;
 }
 
+template <options O, typename T, typename Container>
+typename std::enable_if<is_specialization<T, std::unique_ptr>::value,
+                        void>::type
+validate_bytes(Container &bytes, std::size_t &byte_index,
+               std::size_t &end_index, std::error_code &error_code) {
+  if (end_of_input<O>(byte_index, end_index)) {
+    // end of input
+    return;
+  }
+
+  if (!has_bytes<O>(1, byte_index, end_index, error_code)) {
+    return;
+  }
+
+  // has_value byte must be either 0 or 1
+  const auto has_value = static_cast<uint8_t>(bytes[byte_index++]);
+  if (has_value > 1) {
+    error_code = std::make_error_code(std::errc::illegal_byte_sequence);
+    return;
+  }
+
+  if (has_value) {
+    validate_router<O, typename T::element_type>(bytes, byte_index, end_index,
+                                                 error_code);
+  }
+}
+
 } // namespace detail
 
 } // namespace alpaca
@@ -1,6 +1,7 @@
 #pragma once
 #ifndef ALPACA_EXCLUDE_SUPPORT_STD_VARIANT
 #include <alpaca/detail/type_info.h>
+#include <alpaca/detail/validate.h>
 #include <alpaca/detail/variable_length_encoding.h>
 #include <alpaca/detail/variant_nth_field.h>
 #include <system_error>
@@ -58,7 +59,7 @@ bool from_bytes(std::variant<T...> &output, Container &bytes,
                 std::size_t &byte_index, std::size_t &end_index,
                 std::error_code &error_code) {
 
-  if (byte_index >= end_index) {
+  if (end_of_input<O>(byte_index, end_index)) {
     // end of input
     // return true for forward compatibility
     return true;
@@ -76,6 +77,48 @@ bool from_bytes(std::variant<T...> &output, Container &bytes,
   return true;
 }
 
+template <options O, typename T, typename Container, std::size_t I>
+void validate_variant_alternative(std::size_t index, Container &bytes,
+                                  std::size_t &byte_index,
+                                  std::size_t &end_index,
+                                  std::error_code &error_code) {
+  if constexpr (I < std::variant_size_v<T>) {
+    if (index == I) {
+      validate_router<O, std::variant_alternative_t<I, T>>(
+          bytes, byte_index, end_index, error_code);
+    } else {
+      validate_variant_alternative<O, T, Container, I + 1>(
+          index, bytes, byte_index, end_index, error_code);
+    }
+  } else {
+    // index does not name an alternative of T
+    error_code = std::make_error_code(std::errc::illegal_byte_sequence);
+  }
+}
+
+template <options O, typename T, typename Container>
+typename std::enable_if<is_specialization<T, std::variant>::value, void>::type
+validate_bytes(Container &bytes, std::size_t &byte_index,
+               std::size_t &end_index, std::error_code &error_code) {
+  if (end_of_input<O>(byte_index, end_index)) {
+    // end of input
+    return;
+  }
+
+  // index of the variant value
+  std::size_t index_begin = byte_index;
+  validate_bytes<O, std::size_t>(bytes, byte_index, end_index, error_code);
+  if (error_code) {
+    return;
+  }
+  std::size_t index = 0;
+  from_bytes<O, std::size_t>(index, bytes, index_begin, end_index,
+                             error_code);
+
+  validate_variant_alternative<O, T, Container, 0>(index, bytes, byte_index,
+                                                   end_index, error_code);
+}
+
 } // namespace detail
 
 } // namespace alpaca
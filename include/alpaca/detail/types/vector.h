@@ -1,7 +1,12 @@
 #pragma once
 #ifndef ALPACA_EXCLUDE_SUPPORT_STD_VECTOR
+#include <alpaca/detail/from_bytes.h>
+#include <alpaca/detail/is_wire_trivial.h>
+#include <alpaca/detail/packed_bits.h>
+#include <alpaca/detail/stream_vbyte.h>
 #include <alpaca/detail/to_bytes.h>
 #include <alpaca/detail/type_info.h>
+#include <alpaca/detail/validate.h>
 #include <system_error>
 #include <vector>
 
@@ -26,12 +31,28 @@ template <options O, typename T, typename Container>
 void to_bytes_from_vector_type(const T &input, Container &bytes,
                                std::size_t &byte_index) {
   // save vector size
-  to_bytes_router<O, size_t_serialized_type>((size_t_serialized_type) input.size(), bytes, byte_index);
+  to_bytes_size<O>(bytes, byte_index, input.size());
 
-  // value of each element in list
-  for (const auto &v : input) {
-    // check if the value_type is a nested list type
-    to_bytes_router<O>(v, bytes, byte_index);
+  using value_type = typename T::value_type;
+  if constexpr (std::is_same_v<value_type, bool>) {
+    // 8 values to a byte
+    append_packed_bits(input, input.size(), bytes, byte_index);
+  } else if constexpr (stream_vbyte<O>() &&
+                       is_stream_vbyte_integer<value_type>()) {
+    // lengths of all the elements, then their values
+    stream_vbyte_encode(input.data(), input.size(), bytes, byte_index);
+  } else if constexpr (is_wire_trivial<value_type, O>::value) {
+    // elements are byte-identical on the wire - copy them in one go
+    if (!input.empty()) {
+      append(reinterpret_cast<const uint8_t *>(input.data()),
+             input.size() * sizeof(value_type), bytes, byte_index);
+    }
+  } else {
+    // value of each element in list
+    for (const auto &v : input) {
+      // check if the value_type is a nested list type
+      to_bytes_router<O>(v, bytes, byte_index);
+    }
   }
 }
 
@@ -58,15 +79,15 @@ bool from_bytes_to_vector(std::vector<T> &value, Container &bytes,
                           std::size_t &current_index, std::size_t &end_index,
                           std::error_code &error_code) {
 
-  if (current_index >= end_index) {
+  if (end_of_input<O>(current_index, end_index)) {
     // end of input
     // return true for forward compatibility
     return true;
   }
 
   // current byte is the size of the vector
-  size_t_serialized_type size = 0;
-  detail::from_bytes<O, size_t_serialized_type>(size, bytes, current_index, end_index,
+  serialized_size_type<O> size = 0;
+  detail::from_bytes<O, serialized_size_type<O>>(size, bytes, current_index, end_index,
                                      error_code);
 
   if (size > end_index - current_index) {
@@ -77,16 +98,35 @@ bool from_bytes_to_vector(std::vector<T> &value, Container &bytes,
     return false;
   }
 
-  // read `size` bytes and save to value
-  value.reserve(size * sizeof(T));
+  if constexpr (stream_vbyte<O>() && is_stream_vbyte_integer<T>()) {
+    return stream_vbyte_from_bytes<O>(value, size, bytes, current_index,
+                                      end_index, error_code);
+  }
+
+  if constexpr (is_wire_trivial<T, O>::value) {
+    // elements are byte-identical on the wire - copy them in one go
+    const std::size_t num_bytes = static_cast<std::size_t>(size) * sizeof(T);
+    if (num_bytes <= end_index - current_index) {
+      value.resize(size);
+      if (size > 0) {
+        copy_bytes_from_range(value.data(), num_bytes, bytes, current_index);
+      }
+      return true;
+    }
+  }
+
+  // read `size` elements into value, reusing the existing elements,
+  // and their capacity, if value is not empty
+  value.resize(size);
   for (std::size_t i = 0; i < size; ++i) {
-    T v{};
-    from_bytes_router<O>(v, bytes, current_index, end_index, error_code);
+    // decode in place
+    from_bytes_router<O>(value[i], bytes, current_index, end_index,
+                         error_code);
     if (error_code) {
       // something went wrong
+      value.resize(i);
       return false;
     }
-    value.push_back(v);
   }
 
   return true;
@@ -100,13 +140,51 @@ bool from_bytes(std::vector<T> &output, Container &bytes,
                                  error_code);
 }
 
-// special case for vector<bool>
+// special case for vector<bool>, 8 values to a byte
 template <options O, typename Container>
 bool from_bytes(std::vector<bool> &output, Container &bytes,
                 std::size_t &byte_index, std::size_t &end_index,
                 std::error_code &error_code) {
-  return from_bytes_to_vector<O, bool, Container>(output, bytes, byte_index,
-                                                  end_index, error_code);
+
+  if (end_of_input<O>(byte_index, end_index)) {
+    // end of input
+    // return true for forward compatibility
+    return true;
+  }
+
+  // current byte is the size of the vector
+  serialized_size_type<O> size = 0;
+  detail::from_bytes<O, serialized_size_type<O>>(size, bytes, byte_index,
+                                                end_index, error_code);
+
+  if (packed_bits_size(size) > end_index - byte_index) {
+    // size is greater than the number of bits remaining
+    error_code = std::make_error_code(std::errc::value_too_large);
+
+    // stop here
+    return false;
+  }
+
+  output.resize(size);
+  read_packed_bits(output, size, bytes, byte_index);
+  return true;
+}
+
+template <options O, typename T, typename Container>
+typename std::enable_if<is_specialization<T, std::vector>::value, void>::type
+validate_bytes(Container &bytes, std::size_t &byte_index,
+               std::size_t &end_index, std::error_code &error_code) {
+  using value_type = typename T::value_type;
+  if constexpr (std::is_same_v<value_type, bool>) {
+    validate_packed_bits<O>(bytes, byte_index, end_index, error_code);
+  } else if constexpr (stream_vbyte<O>() &&
+                       is_stream_vbyte_integer<value_type>()) {
+    validate_stream_vbyte<O, value_type>(bytes, byte_index, end_index,
+                                         error_code);
+  } else {
+    validate_sequence<O, value_type>(bytes, byte_index, end_index,
+                                     error_code);
+  }
 }
 
 } // namespace detail
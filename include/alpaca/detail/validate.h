@@ -0,0 +1,163 @@
+#pragma once
+#include <alpaca/detail/endian.h>
+#include <alpaca/detail/from_bytes.h>
+#include <alpaca/detail/is_wire_trivial.h>
+#include <alpaca/detail/options.h>
+#include <alpaca/detail/variable_length_encoding.h>
+#include <cstdint>
+#include <system_error>
+#include <type_traits>
+
+namespace alpaca {
+
+namespace detail {
+
+// Validation
+//
+// validate_bytes<O, T> walks the encoding of a T, serialized with options O,
+// and checks every length, tag and value against the remaining bytes,
+// without constructing a T. Any input that it accepts is decoded by
+// from_bytes<O, T> without error, so validated input can be deserialized
+// with options::trusted_input
+//
+// Like type_info, there is one overload per supported type, selected by T
+
+template <options O, typename T, typename Container>
+void validate_router(Container &bytes, std::size_t &byte_index,
+                     std::size_t &end_index, std::error_code &error_code);
+
+// fundamental types that are always sizeof(T) bytes on the wire and that
+// need no check beyond the number of bytes, i.e., anything but bool
+template <typename T, options O> constexpr bool is_fixed_size_value() {
+  return std::is_arithmetic_v<T> && !std::is_same_v<T, bool> &&
+         !(is_varint_integer<T>::value && !uses_fixed_length_encoding<O>());
+}
+
+// fundamental types
+template <options O, typename T, typename Container>
+typename std::enable_if<std::is_arithmetic_v<T>, void>::type
+validate_bytes(Container &bytes, std::size_t &current_index,
+               std::size_t &end_index, std::error_code &error_code) {
+  if (end_of_input<O>(current_index, end_index)) {
+    // end of input
+    // value is default initialized for forward compatibility
+    return;
+  }
+
+  if constexpr (is_varint_integer<T>::value &&
+                !uses_fixed_length_encoding<O>()) {
+    current_index += varint_size<varint_wire_type<O, T>>(
+        bytes, current_index, end_index, error_code);
+  } else {
+    if (!has_bytes<O>(sizeof(T), current_index, end_index, error_code)) {
+      return;
+    }
+    if constexpr (std::is_same_v<T, bool>) {
+      // anything but 0 or 1 is not a bool
+      if (static_cast<uint8_t>(bytes[current_index]) > 1) {
+        error_code = std::make_error_code(std::errc::illegal_byte_sequence);
+        return;
+      }
+    }
+    current_index += sizeof(T);
+  }
+}
+
+// enum class
+template <options O, typename T, typename Container>
+typename std::enable_if<std::is_enum_v<T>, void>::type
+validate_bytes(Container &bytes, std::size_t &current_index,
+               std::size_t &end_index, std::error_code &error_code) {
+  validate_bytes<O, typename std::underlying_type<T>::type>(
+      bytes, current_index, end_index, error_code);
+}
+
+// validate the length prefix of a container and return it
+template <options O, typename Container>
+serialized_size_type<O> validate_size(Container &bytes,
+                                      std::size_t &current_index,
+                                      std::size_t &end_index,
+                                      std::error_code &error_code) {
+  std::size_t index = current_index;
+  validate_bytes<O, serialized_size_type<O>>(bytes, current_index, end_index,
+                                             error_code);
+  serialized_size_type<O> size = 0;
+  if (!error_code) {
+    from_bytes<O, serialized_size_type<O>>(size, bytes, index, end_index,
+                                           error_code);
+  }
+  return size;
+}
+
+// length prefix followed by that many values of T,
+// e.g., std::vector<T> or std::basic_string<T>
+template <options O, typename T, typename Container>
+void validate_sequence(Container &bytes, std::size_t &current_index,
+                       std::size_t &end_index, std::error_code &error_code) {
+  if (end_of_input<O>(current_index, end_index)) {
+    // end of input
+    return;
+  }
+
+  const auto size = validate_size<O>(bytes, current_index, end_index,
+                                     error_code);
+  if (error_code) {
+    return;
+  }
+
+  if (size > end_index - current_index) {
+    // size is greater than the number of bytes remaining
+    error_code = std::make_error_code(std::errc::value_too_large);
+    return;
+  }
+
+  if constexpr (is_fixed_size_value<T, O>()) {
+    // fixed-size values - skip them in one go if they all fit
+    const std::size_t num_bytes = static_cast<std::size_t>(size) * sizeof(T);
+    if (num_bytes <= end_index - current_index) {
+      current_index += num_bytes;
+      return;
+    }
+  }
+
+  for (std::size_t i = 0; i < size; ++i) {
+    validate_router<O, T>(bytes, current_index, end_index, error_code);
+    if (error_code) {
+      return;
+    }
+  }
+}
+
+// length prefix followed by values of T that are borrowed, not copied,
+// e.g., std::string_view or std::span<const T>
+template <options O, typename T, typename Container>
+void validate_borrowed_range(Container &bytes, std::size_t &current_index,
+                             std::size_t &end_index,
+                             std::error_code &error_code) {
+  if (end_of_input<O>(current_index, end_index)) {
+    // end of input
+    return;
+  }
+
+  const auto size = validate_size<O>(bytes, current_index, end_index,
+                                     error_code);
+  if (error_code) {
+    return;
+  }
+
+  // divide, rather than multiply, so that a large size cannot overflow
+  if (size > (end_index - current_index) / sizeof(T)) {
+    // size is greater than the number of bytes remaining
+    error_code = std::make_error_code(std::errc::value_too_large);
+    return;
+  }
+
+  if (size > 0) {
+    // the values must also be suitably aligned to be borrowed
+    borrow_from_range<T>(bytes, current_index, size, error_code);
+  }
+}
+
+} // namespace detail
+
+} // namespace alpaca
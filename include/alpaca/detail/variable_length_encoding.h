@@ -1,8 +1,19 @@
 #pragma once
+#include <alpaca/detail/endian.h>
 #include <alpaca/detail/output_container.h>
+#include <alpaca/detail/source.h>
+#include <algorithm>
 #include <cstdint>
+#include <cstring>
+#include <system_error>
+#include <type_traits>
 #include <utility>
 #include <vector>
+#if defined(__BMI2__)
+#include <immintrin.h>
+#elif defined(_MSC_VER)
+#include <intrin.h>
+#endif
 
 namespace alpaca {
 
@@ -20,24 +31,82 @@ template <typename T> void RESET_BIT(T &value, uint8_t pos) {
   value = value & ~(T{1} << pos);
 }
 
-template <typename int_t, typename Container>
-bool encode_varint_firstbyte_6(int_t &value, Container &output,
-                               std::size_t &byte_index) {
+// maximum number of 7-bit groups needed to encode int_t
+template <typename int_t> constexpr std::size_t max_varint_7_bytes() {
+  return (sizeof(int_t) * 8 + 6) / 7;
+}
+
+// maximum number of bytes needed to encode int_t
+// (one extra byte for the signed first octet)
+template <typename int_t> constexpr std::size_t max_varint_bytes() {
+  return 1 + max_varint_7_bytes<int_t>();
+}
+
+// encoders write to a local buffer so that the encoded value can be
+// appended to the output in one go
+
+// -value, computed as unsigned so that it is also defined for the most
+// negative value, e.g., INT64_MIN
+template <typename int_t> int_t negate_varint(int_t value) {
+  using uint_t = std::make_unsigned_t<int_t>;
+  return static_cast<int_t>(uint_t{0} - static_cast<uint_t>(value));
+}
+
+// ZigZag encoding maps signed integers to unsigned integers so that values
+// of small magnitude, positive or negative, have small encodings:
+// 0, -1, 1, -2, 2, ... -> 0, 1, 2, 3, 4, ...
+template <typename int_t>
+constexpr std::make_unsigned_t<int_t> zigzag_encode(int_t value) {
+  using uint_t = std::make_unsigned_t<int_t>;
+  return (static_cast<uint_t>(value) << 1) ^
+         static_cast<uint_t>(value >> (sizeof(int_t) * 8 - 1));
+}
+
+template <typename int_t>
+constexpr int_t zigzag_decode(std::make_unsigned_t<int_t> value) {
+  using uint_t = std::make_unsigned_t<int_t>;
+  return static_cast<int_t>((value >> 1) ^ (uint_t{0} - (value & 1)));
+}
+
+// the integer type that is variable-length encoded for an int_t,
+// i.e., its unsigned counterpart for signed types with options::zigzag
+template <options O, typename int_t, typename = void> struct varint_wire {
+  using type = int_t;
+};
+
+template <options O, typename int_t>
+struct varint_wire<O, int_t,
+                   typename std::enable_if<std::is_integral_v<int_t> &&
+                                           std::is_signed_v<int_t> &&
+                                           zigzag<O>()>::type> {
+  using type = std::make_unsigned_t<int_t>;
+};
+
+template <options O, typename int_t>
+using varint_wire_type = typename varint_wire<O, int_t>::type;
+
+// the first octet holds the sign, the continuation flag and the low 6 bits
+// of the magnitude, which is returned in `magnitude`
+template <typename int_t>
+bool encode_varint_firstbyte_6(int_t value,
+                               std::make_unsigned_t<int_t> &magnitude,
+                               uint8_t *buffer, std::size_t &size) {
   uint8_t octet = 0;
+  magnitude = static_cast<std::make_unsigned_t<int_t>>(value);
   if (value < 0) {
-    value *= -1;
+    magnitude = static_cast<std::make_unsigned_t<int_t>>(negate_varint(value));
     SET_BIT(octet, 7);
   }
   // While more than 7 bits of data are left, occupy the last output byte
   // and set the next byte flag
-  if (value > 63) {
+  if (magnitude > 63) {
     // Set the next byte flag
-    octet |= ((uint8_t)(value & 63)) | 64;
-    append(octet, output, byte_index);
+    octet |= ((uint8_t)(magnitude & 63)) | 64;
+    buffer[size++] = octet;
     return true; // multibyte
   } else {
-    octet |= ((uint8_t)(value & 63));
-    append(octet, output, byte_index);
+    octet |= ((uint8_t)(magnitude & 63));
+    buffer[size++] = octet;
     return false; // no more bytes needed
   }
 }
@@ -56,7 +125,8 @@ void encode_varint_6(int_t value, Container &output, std::size_t &byte_index) {
 }
 
 template <typename int_t, typename Container>
-typename std::enable_if<!std::is_same_v<Container, std::ifstream>, int_t>::type
+typename std::enable_if<!detail::is_stream_source<Container>::value,
+                        int_t>::type
 decode_varint_firstbyte_6(Container &input, std::size_t &current_index,
                           bool &negative, bool &multibyte) {
   int octet = 0;
@@ -76,7 +146,8 @@ decode_varint_firstbyte_6(Container &input, std::size_t &current_index,
 }
 
 template <typename int_t, typename Container>
-typename std::enable_if<std::is_same_v<Container, std::ifstream>, int_t>::type
+typename std::enable_if<detail::is_stream_source<Container>::value,
+                        int_t>::type
 decode_varint_firstbyte_6(Container &input, std::size_t &current_index,
                           bool &negative, bool &multibyte) {
   int octet = 0;
@@ -103,7 +174,8 @@ decode_varint_firstbyte_6(Container &input, std::size_t &current_index,
 }
 
 template <typename int_t, typename Container>
-typename std::enable_if<!std::is_same_v<Container, std::ifstream>, int_t>::type
+typename std::enable_if<!detail::is_stream_source<Container>::value,
+                        int_t>::type
 decode_varint_6(Container &input, std::size_t &current_index) {
   int_t ret = 0;
   for (std::size_t i = 0; i < sizeof(int_t); ++i) {
@@ -117,9 +189,10 @@ decode_varint_6(Container &input, std::size_t &current_index) {
   return ret;
 }
 
-// ifstream version
+// stream version
 template <typename int_t, typename Container>
-typename std::enable_if<std::is_same_v<Container, std::ifstream>, int_t>::type
+typename std::enable_if<detail::is_stream_source<Container>::value,
+                        int_t>::type
 decode_varint_6(Container &input, std::size_t &current_index) {
   int_t ret = 0;
   for (std::size_t i = 0; i < sizeof(int_t); ++i) {
@@ -139,56 +212,223 @@ decode_varint_6(Container &input, std::size_t &current_index) {
   return ret;
 }
 
-template <typename int_t, typename Container>
-void encode_varint_7(int_t value, Container &output, std::size_t &byte_index) {
-  if (value < 0) {
-    value *= 1;
-  }
+template <typename int_t>
+void encode_varint_7(int_t value, uint8_t *buffer, std::size_t &size) {
   // While more than 7 bits of data are left, occupy the last output byte
   // and set the next byte flag
   while (value > 127) {
     //|128: Set the next byte flag
-    append(((uint8_t)(value & 127)) | 128, output, byte_index);
+    buffer[size++] = ((uint8_t)(value & 127)) | 128;
     // Remove the seven bits we just wrote
     value >>= 7;
   }
-  append(((uint8_t)value) & 127, output, byte_index);
+  buffer[size++] = ((uint8_t)value) & 127;
 }
 
 template <typename int_t, typename Container>
-typename std::enable_if<!std::is_same_v<Container, std::ifstream>, int_t>::type
+typename std::enable_if<!detail::is_stream_source<Container>::value,
+                        int_t>::type
 decode_varint_7(Container &input, std::size_t &current_index) {
-  int_t ret = 0;
-  for (std::size_t i = 0; i < sizeof(int_t); ++i) {
-    ret |= (static_cast<int_t>(input[current_index + i] & 127)) << (7 * i);
-    // If the next-byte flag is set
-    if (!(input[current_index + i] & 128)) {
-      current_index += i + 1;
+  // accumulate unsigned to shift into the sign bit without overflow
+  using uint_t = std::make_unsigned_t<int_t>;
+  uint_t ret = 0;
+  std::size_t i = 0;
+  while (i < max_varint_7_bytes<int_t>()) {
+    const uint8_t byte = input[current_index + i++];
+    ret |= static_cast<uint_t>(byte & 127) << (7 * (i - 1));
+    // If the next-byte flag is not set
+    if (!(byte & 128)) {
       break;
     }
   }
-  return ret;
+  current_index += i;
+  return static_cast<int_t>(ret);
 }
 
-// ifstream version
+// stream version
 template <typename int_t, typename Container>
-int_t decode_varint_7(std::ifstream &input, std::size_t &current_index) {
-  int_t ret = 0;
-  for (std::size_t i = 0; i < sizeof(int_t); ++i) {
+typename std::enable_if<detail::is_stream_source<Container>::value,
+                        int_t>::type
+decode_varint_7(Container &input, std::size_t &current_index) {
+  // accumulate unsigned to shift into the sign bit without overflow
+  using uint_t = std::make_unsigned_t<int_t>;
+  uint_t ret = 0;
+  std::size_t i = 0;
+  while (i < max_varint_7_bytes<int_t>()) {
 
     // read byte from file stream
     char current_byte;
     input.read(&current_byte, 1);
     uint8_t byte = static_cast<uint8_t>(current_byte);
 
-    ret |= (static_cast<int_t>(byte & 127)) << (7 * i);
-    // If the next-byte flag is set
+    ret |= static_cast<uint_t>(byte & 127) << (7 * i++);
+    // If the next-byte flag is not set
     if (!(byte & 128)) {
-      current_index += i + 1;
       break;
     }
   }
-  return ret;
+  current_index += i;
+  return static_cast<int_t>(ret);
+}
+
+// Fast path for decoding varint_7
+//
+// Instead of one byte, and one branch, at a time, 8 bytes are loaded at
+// once. The continuation flags locate the last byte of the encoding, and
+// the 7-bit groups up to it are gathered into the value with pext when
+// BMI2 is available at compile time, or with a few shifts and masks
+// otherwise. Encodings longer than 8 bytes, i.e., values of 2^56 or more,
+// are left to the byte-by-byte decoder
+
+// number of bytes loaded at once
+constexpr std::size_t varint_word_bytes = 8;
+
+// index of the lowest set bit of x, x must not be 0
+inline unsigned count_trailing_zeros(uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+  return static_cast<unsigned>(__builtin_ctzll(x));
+#elif defined(_MSC_VER) && defined(_M_X64)
+  unsigned long index;
+  _BitScanForward64(&index, x);
+  return static_cast<unsigned>(index);
+#else
+  unsigned n = 0;
+  while (!(x & 1)) {
+    x >>= 1;
+    ++n;
+  }
+  return n;
+#endif
+}
+
+// decode the varint_7 that starts at data, which must have at least
+// varint_word_bytes readable bytes
+//
+// returns false, and consumes nothing, if the encoding does not end within
+// those bytes or is longer than the byte-by-byte decoder reads for int_t
+template <typename int_t>
+bool decode_varint_7_word(const uint8_t *data, std::size_t &current_index,
+                          int_t &value) {
+  if constexpr (!is_system_little_endian()) {
+    return false;
+  } else {
+    uint64_t word;
+    std::memcpy(&word, data, sizeof(word));
+
+    // the high bit of each byte that ends the encoding
+    uint64_t stops = ~word & 0x8080808080808080ull;
+    if constexpr (max_varint_7_bytes<int_t>() < varint_word_bytes) {
+      stops &= (uint64_t{1} << (8 * max_varint_7_bytes<int_t>())) - 1;
+    }
+    if (stops == 0) {
+      return false;
+    }
+
+    // every bit up to, and including, the last byte of the encoding
+    const uint64_t last = stops ^ (stops - 1);
+
+#if defined(__BMI2__)
+    const uint64_t bits = _pext_u64(word & last, 0x7f7f7f7f7f7f7f7full);
+#else
+    // gather the 7-bit groups: 8 x 7 bits -> 4 x 14 -> 2 x 28 -> 56 bits
+    uint64_t bits = word & last & 0x7f7f7f7f7f7f7f7full;
+    bits = ((bits & 0x7f007f007f007f00ull) >> 1) |
+           (bits & 0x007f007f007f007full);
+    bits = ((bits & 0x3fff00003fff0000ull) >> 2) |
+           (bits & 0x00003fff00003fffull);
+    bits = ((bits & 0x0fffffff00000000ull) >> 4) |
+           (bits & 0x000000000fffffffull);
+#endif
+
+    value = static_cast<int_t>(bits);
+    current_index += count_trailing_zeros(stops) / 8 + 1;
+    return true;
+  }
+}
+
+// decode an unsigned varint at data, with at least varint_word_bytes
+// readable bytes
+template <typename int_t>
+typename std::enable_if<std::is_integral_v<int_t> && !std::is_signed_v<int_t>,
+                        bool>::type
+decode_varint_word(const uint8_t *data, std::size_t &current_index,
+                   int_t &value) {
+  return decode_varint_7_word<int_t>(data, current_index, value);
+}
+
+// decode a signed varint at data, with at least varint_word_bytes + 1
+// readable bytes
+template <typename int_t>
+typename std::enable_if<std::is_integral_v<int_t> && std::is_signed_v<int_t>,
+                        bool>::type
+decode_varint_word(const uint8_t *data, std::size_t &current_index,
+                   int_t &value) {
+  // first octet holds the sign, the continuation flag and 6 bits
+  const uint8_t first = data[0];
+  int_t ret = first & 63;
+  std::size_t size = 1;
+  if (first & 64) {
+    int_t rest = 0;
+    if (!decode_varint_7_word<int_t>(data + 1, size, rest)) {
+      return false;
+    }
+    ret |= rest;
+  }
+  if (first & 128) {
+    ret = negate_varint(ret);
+  }
+  value = ret;
+  current_index += size;
+  return true;
+}
+
+// number of readable bytes that decode_varint_word needs
+template <typename int_t> constexpr std::size_t varint_word_input_bytes() {
+  return varint_word_bytes + (std::is_signed_v<int_t> ? 1 : 0);
+}
+
+// number of bytes in the variable-length encoding of an int_t that starts
+// at current_index
+//
+// returns 0, and sets error_code, if the encoding is cut off by end_index
+// or is longer than any encoding of an int_t
+template <typename int_t, typename Container>
+std::size_t varint_size(Container &input, std::size_t current_index,
+                        std::size_t end_index, std::error_code &error_code) {
+  std::size_t index = current_index;
+  if constexpr (std::is_signed_v<int_t>) {
+    // first octet holds the sign, the continuation flag and 6 bits
+    if (index >= end_index) {
+      error_code = std::make_error_code(std::errc::message_size);
+      return 0;
+    }
+    if (!(input[index++] & 64)) {
+      return 1;
+    }
+  }
+  // copy the bytes that are both in the input and in an encoding, so that
+  // every byte that is looked at below is known to be within end_index
+  constexpr auto max_bytes = max_varint_7_bytes<int_t>();
+  const std::size_t remaining = index < end_index ? end_index - index : 0;
+  const std::size_t size = std::min<std::size_t>(remaining, max_bytes);
+  uint8_t buffer[max_bytes] = {};
+  if (size > 0) {
+    std::memcpy(buffer, &input[index], size);
+  }
+
+  for (std::size_t i = 0; i < size; ++i) {
+    if (!(buffer[i] & 128)) {
+      return index + i + 1 - current_index;
+    }
+  }
+  if (size < max_bytes) {
+    // cut off by the end of the input
+    error_code = std::make_error_code(std::errc::message_size);
+  } else {
+    // continuation flag set on the last possible byte
+    error_code = std::make_error_code(std::errc::illegal_byte_sequence);
+  }
+  return 0;
 }
 
 // Unsigned integer variable-length encoding functions
@@ -196,13 +436,34 @@ template <typename int_t, typename Container>
 typename std::enable_if<std::is_integral_v<int_t> && !std::is_signed_v<int_t>,
                         void>::type
 encode_varint(int_t value, Container &output, std::size_t &byte_index) {
-  encode_varint_7<int_t>(value, output, byte_index);
+  uint8_t buffer[max_varint_bytes<int_t>()];
+  std::size_t size = 0;
+  encode_varint_7<int_t>(value, buffer, size);
+  append(buffer, size, output, byte_index);
 }
 
 template <typename int_t, typename Container>
 typename std::enable_if<std::is_integral_v<int_t> && !std::is_signed_v<int_t>,
                         int_t>::type
 decode_varint(Container &input, std::size_t &current_index) {
+  if constexpr (has_window<Container>::value) {
+    // decode directly from the buffered window, when the
+    // longest possible encoding is available
+    constexpr auto max_size =
+        std::max(max_varint_bytes<int_t>(), varint_word_input_bytes<int_t>());
+    const uint8_t *window = input.window(max_size);
+    if (input.available() >= max_size) {
+      std::size_t index = 0;
+      int_t value;
+      if (!decode_varint_word<int_t>(window, index, value)) {
+        value = decode_varint<int_t>(window, index);
+      }
+      input.consume(index);
+      current_index += index;
+      return value;
+    }
+  }
+
   return decode_varint_7<int_t, Container>(input, current_index);
 }
 
@@ -211,17 +472,39 @@ template <typename int_t, typename Container>
 typename std::enable_if<std::is_integral_v<int_t> && std::is_signed_v<int_t>,
                         void>::type
 encode_varint(int_t value, Container &output, std::size_t &byte_index) {
+  uint8_t buffer[max_varint_bytes<int_t>()];
+  std::size_t size = 0;
   // first octet
-  if (encode_varint_firstbyte_6<int_t>(value, output, byte_index)) {
+  std::make_unsigned_t<int_t> magnitude = 0;
+  if (encode_varint_firstbyte_6<int_t>(value, magnitude, buffer, size)) {
     // rest of the octets
-    encode_varint_7<int_t>(value, output, byte_index);
+    encode_varint_7(magnitude, buffer, size);
   }
+  append(buffer, size, output, byte_index);
 }
 
 template <typename int_t, typename Container>
 typename std::enable_if<std::is_integral_v<int_t> && std::is_signed_v<int_t>,
                         int_t>::type
 decode_varint(Container &input, std::size_t &current_index) {
+  if constexpr (has_window<Container>::value) {
+    // decode directly from the buffered window, when the
+    // longest possible encoding is available
+    constexpr auto max_size =
+        std::max(max_varint_bytes<int_t>(), varint_word_input_bytes<int_t>());
+    const uint8_t *window = input.window(max_size);
+    if (input.available() >= max_size) {
+      std::size_t index = 0;
+      int_t value;
+      if (!decode_varint_word<int_t>(window, index, value)) {
+        value = decode_varint<int_t>(window, index);
+      }
+      input.consume(index);
+      current_index += index;
+      return value;
+    }
+  }
+
   // decode first byte
   bool is_negative = false, multibyte = false;
   auto ret = decode_varint_firstbyte_6<int_t, Container>(
@@ -234,12 +517,43 @@ decode_varint(Container &input, std::size_t &current_index) {
   }
 
   if (is_negative) {
-    ret *= -1;
+    ret = negate_varint(ret);
   }
 
   return ret;
 }
 
+// indexed input version, uses the fast path when enough input remains
+// and decodes a zero-padded copy of the input close to its end, so that
+// nothing past end_index is read
+template <typename int_t, typename Container>
+typename std::enable_if<!detail::is_stream_source<Container>::value,
+                        int_t>::type
+decode_varint(Container &input, std::size_t &current_index,
+              std::size_t end_index) {
+  const std::size_t remaining =
+      current_index < end_index ? end_index - current_index : 0;
+  if (remaining >= varint_word_input_bytes<int_t>()) {
+    const uint8_t *data =
+        reinterpret_cast<const uint8_t *>(&input[0]) + current_index;
+    int_t value;
+    if (decode_varint_word<int_t>(data, current_index, value)) {
+      return value;
+    }
+  }
+  if (remaining < max_varint_bytes<int_t>()) {
+    uint8_t buffer[max_varint_bytes<int_t>()] = {};
+    if (remaining > 0) {
+      std::memcpy(buffer, &input[current_index], remaining);
+    }
+    std::size_t index = 0;
+    const auto value = decode_varint<int_t>(buffer, index);
+    current_index += index;
+    return value;
+  }
+  return decode_varint<int_t>(input, current_index);
+}
+
 } // namespace detail
 
 } // namespace alpaca
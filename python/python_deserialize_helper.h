@@ -67,6 +67,21 @@ void load_vector(const std::string &format, std::size_t &index,
 
   auto value_type = get_value_type_vector(format, index);
 
+  if (value_type == "?") {
+    // std::vector<bool> is packed 8 bits to a byte
+    if (detail::packed_bits_size(size) > end_index - byte_index) {
+      throw std::runtime_error("Invalid vector size");
+    }
+    std::vector<bool> bits(size);
+    detail::read_packed_bits(bits, size, bytes, byte_index);
+    py::list values;
+    for (bool bit : bits) {
+      values.append(bit);
+    }
+    result.append(values);
+    return;
+  }
+
   std::string value_format_list{""};
   for (std::size_t i = 0; i < size; ++i) {
     value_format_list += value_type;
@@ -147,6 +147,18 @@ void parse_vector(const std::string &format, It it, std::size_t &index,
   detail::to_bytes_router<OPTIONS>(size, result, byte_index);
 
   auto value_type = get_value_type_vector(format, index);
+  auto list = py::cast<py::list>(*it);
+
+  if (value_type == "?") {
+    // std::vector<bool> is packed 8 bits to a byte
+    std::vector<bool> bits;
+    bits.reserve(size);
+    for (auto item : list) {
+      bits.push_back(item.cast<bool>());
+    }
+    detail::append_packed_bits(bits, bits.size(), result, byte_index);
+    return;
+  }
 
   std::string value_format_list{""};
   for (std::size_t i = 0; i < size; ++i) {
@@ -154,7 +166,6 @@ void parse_vector(const std::string &format, It it, std::size_t &index,
   }
 
   // recurse - save all values
-  auto list = py::cast<py::list>(*it);
   auto serialized = serialize(value_format_list, list);
 
   for (auto &b : serialized) {
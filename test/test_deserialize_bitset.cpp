@@ -0,0 +1,85 @@
+#include <alpaca/alpaca.h>
+#include <doctest.hpp>
+using namespace alpaca;
+
+using doctest::test_suite;
+
+namespace {
+
+template <std::size_t N> std::bitset<N> make_bitset() {
+  std::bitset<N> value;
+  for (std::size_t i = 0; i < N; ++i) {
+    value[i] = (i % 3 == 0 || i % 5 == 0);
+  }
+  return value;
+}
+
+template <std::size_t N> void check_bitset() {
+  struct my_struct {
+    std::bitset<N> value;
+    int after;
+  };
+
+  std::vector<uint8_t> bytes;
+  serialize(my_struct{make_bitset<N>(), -5}, bytes);
+  // size, N bits packed into (N + 7)/8 bytes, then 1 byte for `after`
+  REQUIRE(bytes.size() == (N < 128 ? 1 : 2) + (N + 7) / 8 + 1);
+
+  std::error_code ec;
+  REQUIRE(validate<my_struct>(bytes, ec));
+  auto result = deserialize<my_struct>(bytes, ec);
+  REQUIRE((bool)ec == false);
+  REQUIRE(result.value == make_bitset<N>());
+  REQUIRE(result.after == -5);
+}
+
+} // namespace
+
+TEST_CASE("Serialize bitset" * test_suite("bitset")) {
+  struct my_struct {
+    std::bitset<16> value;
+  };
+
+  std::vector<uint8_t> bytes;
+  serialize(my_struct{std::bitset<16>{0x8421}}, bytes);
+  // no extra byte when the size is a multiple of 8
+  REQUIRE(bytes.size() == 3);
+  REQUIRE(bytes[0] == 16);
+  REQUIRE(bytes[1] == 0x21);
+  REQUIRE(bytes[2] == 0x84);
+}
+
+TEST_CASE("Deserialize bitset" * test_suite("bitset")) {
+  check_bitset<1>();
+  check_bitset<7>();
+  check_bitset<8>();
+  check_bitset<9>();
+  check_bitset<64>();
+  check_bitset<65>();
+  check_bitset<200>();
+  check_bitset<1024>();
+}
+
+TEST_CASE("Deserialize truncated bitset" * test_suite("bitset")) {
+  struct my_struct {
+    std::bitset<100> value;
+  };
+
+  std::vector<uint8_t> bytes;
+  serialize(my_struct{make_bitset<100>()}, bytes);
+
+  std::error_code ec;
+  deserialize<my_struct>(bytes, bytes.size() - 1, ec);
+  REQUIRE(ec == std::errc::value_too_large);
+
+  ec.clear();
+  REQUIRE(validate<my_struct>(bytes, bytes.size() - 1, ec) == false);
+
+  // a bitset of a different size
+  struct other_struct {
+    std::bitset<99> value;
+  };
+  ec.clear();
+  deserialize<other_struct>(bytes, ec);
+  REQUIRE(ec == std::errc::invalid_argument);
+}
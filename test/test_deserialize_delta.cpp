@@ -0,0 +1,106 @@
+#include <alpaca/alpaca.h>
+#include <doctest.hpp>
+using namespace alpaca;
+
+using doctest::test_suite;
+
+TEST_CASE("Serialize delta" * test_suite("delta")) {
+  struct my_struct {
+    delta<std::vector<uint64_t>> ids;
+  };
+
+  my_struct s{{1000000000000, 1000000000001, 1000000000003, 1000000000003}};
+
+  std::vector<uint8_t> bytes;
+  serialize(s, bytes);
+
+  struct plain_struct {
+    std::vector<uint64_t> ids;
+  };
+  std::vector<uint8_t> plain;
+  serialize(plain_struct{s.ids}, plain);
+
+  // size, first value, then 1 byte per difference
+  REQUIRE(bytes.size() == 1 + 6 + 3);
+  REQUIRE(bytes.size() < plain.size());
+  REQUIRE(bytes[7] == 0x02); // ZigZag of +1
+  REQUIRE(bytes[8] == 0x04); // +2
+  REQUIRE(bytes[9] == 0x00); // +0
+
+  std::error_code ec;
+  auto result = deserialize<my_struct>(bytes, ec);
+  REQUIRE((bool)ec == false);
+  REQUIRE(result.ids == s.ids);
+}
+
+TEST_CASE("Deserialize delta containers" * test_suite("delta")) {
+  using namespace std::chrono_literals;
+
+  struct my_struct {
+    delta<std::vector<uint32_t>> a;
+    delta<std::vector<int64_t>> b;
+    delta<std::set<uint64_t>> c;
+    delta<std::deque<std::chrono::nanoseconds>> d;
+    delta<std::list<int16_t>> e;
+    std::string f;
+  };
+
+  my_struct s;
+  // more than 4 values to go through the vectorized prefix sum, and values
+  // that are not sorted
+  for (uint32_t i = 0; i < 103; ++i) {
+    s.a.push_back(i % 7 == 0 ? 0xffffffff - i : i * 1000);
+    s.b.push_back(i % 2 == 0 ? -int64_t{i} * 100000 : int64_t{i} << 40);
+    s.c.insert(1700000000000000000 + i * i);
+  }
+  s.b.push_back(std::numeric_limits<int64_t>::min());
+  s.b.push_back(std::numeric_limits<int64_t>::max());
+  s.d = {1600000000000000000ns, 1600000000000000100ns, 1600000000000000099ns};
+  s.e = {-32768, 32767, 0, -1};
+  s.f = "delta";
+
+  std::vector<uint8_t> bytes;
+  serialize(s, bytes);
+
+  std::error_code ec;
+  REQUIRE(validate<my_struct>(bytes, ec));
+
+  auto result = deserialize<my_struct>(bytes, ec);
+  REQUIRE((bool)ec == false);
+  REQUIRE(result.a == s.a);
+  REQUIRE(result.b == s.b);
+  REQUIRE(result.c == s.c);
+  REQUIRE(result.d == s.d);
+  REQUIRE(result.e == s.e);
+  REQUIRE(result.f == s.f);
+
+  // the differences do not depend on the options
+  constexpr auto O = options::fixed_length_encoding | options::big_endian |
+                     options::with_version;
+  bytes.clear();
+  serialize<O>(s, bytes);
+  result = deserialize<O, my_struct>(bytes, ec);
+  REQUIRE((bool)ec == false);
+  REQUIRE(result.b == s.b);
+  REQUIRE(result.d == s.d);
+  REQUIRE(result.e == s.e);
+}
+
+TEST_CASE("Deserialize truncated delta" * test_suite("delta")) {
+  struct my_struct {
+    delta<std::vector<uint64_t>> a;
+  };
+
+  std::vector<uint8_t> bytes;
+  serialize(my_struct{{1, 1ull << 60, 5}}, bytes);
+
+  for (std::size_t size = 1; size < bytes.size(); ++size) {
+    std::error_code ec;
+    auto result = deserialize<my_struct>(bytes, size, ec);
+    REQUIRE((bool)ec == true);
+    REQUIRE(result.a.empty());
+
+    ec.clear();
+    REQUIRE(validate<my_struct>(bytes, size, ec) == false);
+  }
+}
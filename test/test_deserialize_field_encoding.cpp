@@ -0,0 +1,151 @@
+#include <alpaca/alpaca.h>
+#include <doctest.hpp>
+using namespace alpaca;
+
+using doctest::test_suite;
+
+namespace {
+
+struct entry {
+  fixed<uint64_t> hash;
+  varint<uint32_t> count;
+  alpaca::bytes<5> offset;
+  int32_t other;
+};
+
+} // namespace
+
+TEST_CASE("Serialize per-field encoding" * test_suite("field_encoding")) {
+  std::vector<uint8_t> bytes;
+  serialize(entry{0x1122334455667788, 3, 0x0102030405, 4}, bytes);
+  REQUIRE(bytes.size() == 8 + 1 + 5 + 1);
+  // hash
+  REQUIRE(bytes[0] == 0x88);
+  REQUIRE(bytes[7] == 0x11);
+  // count
+  REQUIRE(bytes[8] == 0x03);
+  // offset
+  REQUIRE(bytes[9] == 0x05);
+  REQUIRE(bytes[13] == 0x01);
+  // other
+  REQUIRE(bytes[14] == 0x04);
+
+  // the wrappers keep their encoding with fixed length encoding
+  bytes.clear();
+  serialize<options::fixed_length_encoding>(
+      entry{0x1122334455667788, 3, 0x0102030405, 4}, bytes);
+  REQUIRE(bytes.size() == 8 + 1 + 5 + 4);
+
+  // and with big endian byte order
+  bytes.clear();
+  serialize<options::big_endian>(entry{0x1122334455667788, 3, 0x0102030405, 4},
+                                 bytes);
+  REQUIRE(bytes.size() == 8 + 1 + 5 + 4);
+  REQUIRE(bytes[0] == 0x11);
+  REQUIRE(bytes[8] == 0x03);
+  REQUIRE(bytes[9] == 0x01);
+  REQUIRE(bytes[13] == 0x05);
+}
+
+TEST_CASE("Deserialize per-field encoding" * test_suite("field_encoding")) {
+  auto check = [](auto tag) {
+    constexpr auto O = decltype(tag)::value;
+    const entry input{0xfedcba9876543210, 1u << 30, 0xffffffffff, -7};
+
+    std::vector<uint8_t> bytes;
+    serialize<O>(input, bytes);
+
+    std::error_code ec;
+    REQUIRE(validate<entry, O>(bytes, ec));
+    auto result = deserialize<O, entry>(bytes, ec);
+    REQUIRE((bool)ec == false);
+    REQUIRE(result.hash == 0xfedcba9876543210);
+    REQUIRE(result.count == 1u << 30);
+    REQUIRE(result.offset == 0xffffffffff);
+    REQUIRE(result.other == -7);
+
+    // truncated input
+    ec.clear();
+    deserialize<O, entry>(bytes, 11, ec);
+    REQUIRE(ec == std::errc::message_size);
+    ec.clear();
+    REQUIRE(validate<entry, O>(bytes, 11, ec) == false);
+  };
+  check(std::integral_constant<options, options::none>{});
+  check(std::integral_constant<options, options::fixed_length_encoding>{});
+  check(std::integral_constant<options, options::big_endian>{});
+  check(std::integral_constant<options, options::zigzag>{});
+}
+
+TEST_CASE("Use per-field encoding like the underlying type" *
+          test_suite("field_encoding")) {
+  entry e{};
+  e.hash = 5;
+  e.count = e.count + 2;
+  e.offset.value() += 1;
+  uint64_t hash = e.hash;
+  REQUIRE(hash == 5);
+  REQUIRE(e.count == 2);
+  REQUIRE(e.offset == 1);
+
+  // only the low N bytes are written
+  struct small {
+    alpaca::bytes<3> value;
+  };
+  std::vector<uint8_t> bytes;
+  serialize(small{0x12345678}, bytes);
+  REQUIRE(bytes.size() == 3);
+
+  std::error_code ec;
+  auto result = deserialize<small>(bytes, ec);
+  REQUIRE((bool)ec == false);
+  REQUIRE(result.value == 0x345678);
+
+  // vectors of wrappers
+  struct hashes {
+    std::vector<fixed<uint64_t>> values;
+  };
+  bytes.clear();
+  serialize(hashes{{1, 0xffffffffffffffff, 3}}, bytes);
+  REQUIRE(bytes.size() == 1 + 3 * 8);
+
+  auto h = deserialize<hashes>(bytes, ec);
+  REQUIRE((bool)ec == false);
+  REQUIRE(h.values.size() == 3);
+  REQUIRE(h.values[1] == 0xffffffffffffffff);
+}
+
+TEST_CASE("Per-field encoding changes the version" *
+          test_suite("field_encoding")) {
+  struct plain {
+    uint64_t a;
+  };
+  struct with_fixed {
+    fixed<uint64_t> a;
+  };
+  struct with_varint {
+    varint<uint64_t> a;
+  };
+  struct with_bytes {
+    alpaca::bytes<8> a;
+  };
+
+  const auto plain_hash = detail::type_hash<plain, 1>();
+  REQUIRE(detail::type_hash<with_fixed, 1>() != plain_hash);
+  REQUIRE(detail::type_hash<with_varint, 1>() != plain_hash);
+  REQUIRE(detail::type_hash<with_bytes, 1>() != plain_hash);
+  REQUIRE(detail::type_hash<with_fixed, 1>() !=
+          detail::type_hash<with_varint, 1>());
+
+  std::vector<uint8_t> bytes;
+  serialize<options::with_version>(with_fixed{1}, bytes);
+  std::error_code ec;
+  deserialize<options::with_version, with_varint>(bytes, ec);
+  REQUIRE(ec == std::errc::invalid_argument);
+
+  REQUIRE(is_wire_trivial_v<fixed<uint64_t>> ==
+          detail::is_system_little_endian());
+  REQUIRE(is_wire_trivial_v<alpaca::bytes<3>> == false);
+  REQUIRE(detail::fixed_wire_size<options::none, with_fixed>() == 8);
+  REQUIRE(detail::fixed_wire_size<options::none, with_varint>() == 0);
+}
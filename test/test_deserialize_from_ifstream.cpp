@@ -96,4 +96,237 @@ TEST_CASE("Deserialize complex struct from ifstream with options" *
     REQUIRE(recovered.f == s.f);
     std::filesystem::remove("tmp2.bin");
   }
-}
\ No newline at end of file
+}
+TEST_CASE("Deserialize large struct from ifstream" * test_suite("fstream")) {
+  struct my_struct {
+    std::vector<std::string> a;
+    std::vector<int64_t> b;
+    std::vector<float> c;
+    std::u16string d;
+  };
+
+  my_struct s;
+  for (int i = 0; i < 10000; ++i) {
+    s.a.push_back("log entry " + std::to_string(i));
+    s.b.push_back((i % 2 ? -1 : 1) * static_cast<int64_t>(i) * 1000003);
+  }
+  s.c.resize(100000, 3.14f);
+  s.d = u"Hello World";
+
+  {
+    // Serialize to file
+    std::ofstream os;
+    os.open("tmp7.bin", std::ios::out | std::ios::binary);
+    serialize(s, os);
+    os.close();
+  }
+
+  {
+    // Deserialize from file
+    auto size = std::filesystem::file_size("tmp7.bin");
+    std::error_code ec;
+    std::ifstream is;
+    is.open("tmp7.bin", std::ios::in | std::ios::binary);
+    auto recovered = deserialize<my_struct>(is, size, ec);
+    is.close();
+    REQUIRE((bool)ec == false);
+    REQUIRE(recovered.a == s.a);
+    REQUIRE(recovered.b == s.b);
+    REQUIRE(recovered.c == s.c);
+    REQUIRE(recovered.d == s.d);
+    std::filesystem::remove("tmp7.bin");
+  }
+}
+
+TEST_CASE("Deserialize consecutive objects with buffered_istream_source" *
+          test_suite("fstream")) {
+  struct my_struct {
+    uint32_t a;
+    std::string b;
+    std::vector<int32_t> c;
+  };
+
+  my_struct s1{300, "first", {-1, 100000, -100000}};
+  my_struct s2{70000, "second object", {5, 6, 7, 8, 9}};
+
+  std::size_t size1 = 0, size2 = 0;
+  {
+    // Serialize both objects to the same file
+    std::ofstream os;
+    os.open("tmp8.bin", std::ios::out | std::ios::binary);
+    size1 = serialize(s1, os);
+    size2 = serialize(s2, os);
+    os.close();
+  }
+
+  {
+    std::ifstream is;
+    is.open("tmp8.bin", std::ios::in | std::ios::binary);
+
+    // a tiny block size forces varints and strings across refills
+    std::error_code ec;
+    buffered_istream_source source1{is, size1, 4};
+    auto recovered1 = deserialize<my_struct>(source1, size1, ec);
+    REQUIRE((bool)ec == false);
+    REQUIRE(recovered1.a == s1.a);
+    REQUIRE(recovered1.b == s1.b);
+    REQUIRE(recovered1.c == s1.c);
+
+    // the stream is left right after the first object
+    auto recovered2 = deserialize<my_struct>(is, size2, ec);
+    REQUIRE((bool)ec == false);
+    REQUIRE(recovered2.a == s2.a);
+    REQUIRE(recovered2.b == s2.b);
+    REQUIRE(recovered2.c == s2.c);
+    is.close();
+    std::filesystem::remove("tmp8.bin");
+  }
+}
+
+TEST_CASE("Serialize and deserialize file with version and checksum" *
+          test_suite("fstream")) {
+  struct my_struct {
+    int a;
+    std::string b;
+    std::vector<uint64_t> c;
+    std::map<std::string, std::array<uint8_t, 3>> d;
+  };
+
+  my_struct s{5,
+              "Hello World",
+              {6, 5, 4, 3, 2, 1},
+              {{"abc", {1, 2, 3}}, {"def", {4, 5, 6}}}};
+
+  constexpr auto OPTIONS = options::with_version | options::with_checksum;
+
+  std::vector<uint8_t> expected;
+  serialize<OPTIONS>(s, expected);
+
+  {
+    // Serialize to file
+    std::ofstream os;
+    os.open("tmp9.bin", std::ios::out | std::ios::binary);
+    auto bytes_written = serialize<OPTIONS>(s, os);
+    os.close();
+    REQUIRE(bytes_written == expected.size());
+
+    std::ifstream is;
+    is.open("tmp9.bin", std::ios::in | std::ios::binary);
+    std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(is)),
+                               std::istreambuf_iterator<char>());
+    is.close();
+    REQUIRE(bytes == expected);
+  }
+
+  {
+    // Deserialize from file
+    auto size = std::filesystem::file_size("tmp9.bin");
+    std::error_code ec;
+    std::ifstream is;
+    is.open("tmp9.bin", std::ios::in | std::ios::binary);
+    auto recovered = deserialize<OPTIONS, my_struct>(is, size, ec);
+    is.close();
+    REQUIRE((bool)ec == false);
+    REQUIRE(recovered.a == s.a);
+    REQUIRE(recovered.b == s.b);
+    REQUIRE(recovered.c == s.c);
+    REQUIRE(recovered.d == s.d);
+  }
+
+  {
+    // Corrupt a byte in the middle of the file
+    std::fstream fs;
+    fs.open("tmp9.bin", std::ios::in | std::ios::out | std::ios::binary);
+    fs.seekp(10);
+    fs.put('x');
+    fs.close();
+
+    auto size = std::filesystem::file_size("tmp9.bin");
+    std::error_code ec;
+    std::ifstream is;
+    is.open("tmp9.bin", std::ios::in | std::ios::binary);
+    deserialize<OPTIONS, my_struct>(is, size, ec);
+    is.close();
+    REQUIRE((bool)ec == true);
+    REQUIRE(ec.value() == static_cast<int>(std::errc::bad_message));
+  }
+
+  std::filesystem::remove("tmp9.bin");
+}
+
+TEST_CASE("Deserialize file with version mismatch" * test_suite("fstream")) {
+  struct my_struct {
+    int a;
+    std::string b;
+  };
+
+  struct my_other_struct {
+    int a;
+    std::vector<int> b;
+  };
+
+  constexpr auto OPTIONS = options::with_version;
+
+  {
+    std::ofstream os;
+    os.open("tmp10.bin", std::ios::out | std::ios::binary);
+    serialize<OPTIONS>(my_struct{5, "abc"}, os);
+    os.close();
+  }
+
+  auto size = std::filesystem::file_size("tmp10.bin");
+  {
+    std::error_code ec;
+    std::ifstream is;
+    is.open("tmp10.bin", std::ios::in | std::ios::binary);
+    auto recovered = deserialize<OPTIONS, my_struct>(is, size, ec);
+    is.close();
+    REQUIRE((bool)ec == false);
+    REQUIRE(recovered.a == 5);
+    REQUIRE(recovered.b == "abc");
+  }
+
+  {
+    std::error_code ec;
+    std::ifstream is;
+    is.open("tmp10.bin", std::ios::in | std::ios::binary);
+    deserialize<OPTIONS, my_other_struct>(is, size, ec);
+    is.close();
+    REQUIRE((bool)ec == true);
+    REQUIRE(ec.value() == static_cast<int>(std::errc::invalid_argument));
+  }
+
+  std::filesystem::remove("tmp10.bin");
+}
+
+TEST_CASE("Deserialize file with checksum into older struct" *
+          test_suite("fstream")) {
+  struct my_struct_v1 {
+    int a;
+  };
+
+  struct my_struct_v2 {
+    int a;
+    std::string b;
+  };
+
+  constexpr auto OPTIONS = options::with_checksum;
+
+  {
+    std::ofstream os;
+    os.open("tmp11.bin", std::ios::out | std::ios::binary);
+    serialize<OPTIONS>(my_struct_v2{5, "field added in v2"}, os);
+    os.close();
+  }
+
+  // the checksum covers the bytes of the new field as well
+  auto size = std::filesystem::file_size("tmp11.bin");
+  std::error_code ec;
+  std::ifstream is;
+  is.open("tmp11.bin", std::ios::in | std::ios::binary);
+  auto recovered = deserialize<OPTIONS, my_struct_v1>(is, size, ec);
+  is.close();
+  REQUIRE((bool)ec == false);
+  REQUIRE(recovered.a == 5);
+  std::filesystem::remove("tmp11.bin");
+}
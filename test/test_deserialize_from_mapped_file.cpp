@@ -0,0 +1,92 @@
+#include <alpaca/alpaca.h>
+#include <doctest.hpp>
+#include <filesystem>
+using namespace alpaca;
+
+using doctest::test_suite;
+
+#ifdef ALPACA_HAS_MAPPED_FILE
+
+TEST_CASE("Deserialize complex struct from mapped_file" *
+          test_suite("mapped_file")) {
+  struct my_struct {
+    int a;
+    bool b;
+    char c;
+    std::string d;
+    std::vector<uint64_t> e;
+    std::map<std::string, std::array<uint8_t, 3>> f;
+  };
+
+  my_struct s{5,
+              true,
+              'a',
+              "Hello World",
+              {6, 5, 4, 3, 2, 1},
+              {{"abc", {1, 2, 3}}, {"def", {4, 5, 6}}}};
+
+  constexpr auto OPTIONS = options::with_version | options::with_checksum;
+
+  {
+    // Serialize to file
+    std::ofstream os;
+    os.open("tmp12.bin", std::ios::out | std::ios::binary);
+    serialize<OPTIONS>(s, os);
+    os.close();
+  }
+
+  {
+    // Deserialize from mapped file
+    std::error_code ec;
+    mapped_file file("tmp12.bin", ec);
+    REQUIRE((bool)ec == false);
+    REQUIRE(file.size() == std::filesystem::file_size("tmp12.bin"));
+
+    auto recovered = deserialize<OPTIONS, my_struct>(file, ec);
+    REQUIRE((bool)ec == false);
+    REQUIRE(recovered.a == s.a);
+    REQUIRE(recovered.b == s.b);
+    REQUIRE(recovered.c == s.c);
+    REQUIRE(recovered.d == s.d);
+    REQUIRE(recovered.e == s.e);
+    REQUIRE(recovered.f == s.f);
+
+    // ownership of the mapping moves with the object
+    mapped_file moved = std::move(file);
+    REQUIRE(file.empty());
+    REQUIRE(moved.size() == std::filesystem::file_size("tmp12.bin"));
+  }
+
+  std::filesystem::remove("tmp12.bin");
+}
+
+TEST_CASE("Deserialize from empty mapped_file" * test_suite("mapped_file")) {
+  struct my_struct {
+    int a;
+  };
+
+  {
+    std::ofstream os;
+    os.open("tmp13.bin", std::ios::out | std::ios::binary);
+    os.close();
+  }
+
+  std::error_code ec;
+  mapped_file file("tmp13.bin", ec, mapped_file::advice::normal);
+  REQUIRE((bool)ec == false);
+  REQUIRE(file.empty());
+
+  deserialize<my_struct>(file, ec);
+  REQUIRE(ec.value() == static_cast<int>(std::errc::message_size));
+  std::filesystem::remove("tmp13.bin");
+}
+
+TEST_CASE("mapped_file error - no such file" * test_suite("mapped_file")) {
+  std::error_code ec;
+  mapped_file file("does_not_exist.bin", ec);
+  REQUIRE((bool)ec == true);
+  REQUIRE(ec == std::errc::no_such_file_or_directory);
+  REQUIRE(file.empty());
+}
+
+#endif
@@ -338,4 +338,46 @@ TEST_CASE("Deserialize signed and unsigned integer types" *
     REQUIRE(result.g == 12345678);
     REQUIRE(result.h == 5294967295);
   }
-}
\ No newline at end of file
+}
+
+TEST_CASE("Deserialize int64_t across varint lengths" *
+          test_suite("signed_integer")) {
+  struct my_struct {
+    std::vector<int64_t> values;
+    int32_t last;
+  };
+
+  // the first and last value of every encoded length, and their negatives
+  std::vector<int64_t> values;
+  for (std::size_t bits = 6; bits < 62; bits += 7) {
+    values.push_back((int64_t{1} << bits) - 1);
+    values.push_back(int64_t{1} << bits);
+    values.push_back(-((int64_t{1} << bits) - 1));
+    values.push_back(-(int64_t{1} << bits));
+  }
+  values.push_back(0);
+  values.push_back(std::numeric_limits<int64_t>::max());
+  values.push_back(std::numeric_limits<int64_t>::min() + 1);
+  values.push_back(std::numeric_limits<int64_t>::min());
+
+  std::vector<uint8_t> bytes;
+  serialize(my_struct{values, -5}, bytes);
+
+  std::error_code ec;
+  auto result = deserialize<my_struct>(bytes, ec);
+  REQUIRE((bool)ec == false);
+  REQUIRE(result.values == values);
+  REQUIRE(result.last == -5);
+
+  // each value on its own, so that some are decoded near the end of input
+  for (auto value : values) {
+    struct single {
+      int64_t value;
+    };
+    bytes.clear();
+    serialize(single{value}, bytes);
+    auto s = deserialize<single>(bytes, ec);
+    REQUIRE((bool)ec == false);
+    REQUIRE(s.value == value);
+  }
+}
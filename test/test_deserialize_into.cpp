@@ -0,0 +1,249 @@
+#include <alpaca/alpaca.h>
+#include <doctest.hpp>
+using namespace alpaca;
+
+using doctest::test_suite;
+
+TEST_CASE("Deserialize into an existing object" *
+          test_suite("deserialize_into")) {
+  struct my_struct {
+    std::vector<std::string> a;
+    std::map<std::string, std::vector<int>> b;
+    std::set<int> c;
+    std::unordered_map<int, std::string> d;
+    std::list<std::string> e;
+    std::deque<int> f;
+  };
+
+  my_struct first{{"a", "bb", "ccc"},
+                  {{"x", {1, 2, 3}}, {"y", {4}}},
+                  {1, 2, 3},
+                  {{1, "one"}, {2, "two"}},
+                  {"abc", "def"},
+                  {5, 6, 7}};
+
+  my_struct second{{"dddd"}, {{"z", {}}}, {}, {{3, "three"}}, {}, {8}};
+
+  std::vector<uint8_t> first_bytes, second_bytes;
+  serialize(first, first_bytes);
+  serialize(second, second_bytes);
+
+  my_struct s;
+  std::error_code ec;
+  for (int i = 0; i < 3; ++i) {
+    deserialize_into(s, first_bytes, ec);
+    REQUIRE((bool)ec == false);
+    REQUIRE(s.a == first.a);
+    REQUIRE(s.b == first.b);
+    REQUIRE(s.c == first.c);
+    REQUIRE(s.d == first.d);
+    REQUIRE(s.e == first.e);
+    REQUIRE(s.f == first.f);
+
+    // nothing from the previous message is left behind
+    deserialize_into(s, second_bytes, ec);
+    REQUIRE((bool)ec == false);
+    REQUIRE(s.a == second.a);
+    REQUIRE(s.b == second.b);
+    REQUIRE(s.c.empty());
+    REQUIRE(s.d == second.d);
+    REQUIRE(s.e.empty());
+    REQUIRE(s.f == second.f);
+  }
+}
+
+TEST_CASE("Deserialize into optional and unique_ptr" *
+          test_suite("deserialize_into")) {
+  struct inner {
+    std::vector<int> values;
+  };
+
+  struct my_struct {
+    int a;
+    std::vector<std::optional<std::string>> b;
+    std::unique_ptr<inner> c;
+  };
+
+  my_struct first{1, {"x", std::nullopt, "y"},
+                  std::make_unique<inner>(inner{{8, 9}})};
+  my_struct second{3, {std::nullopt, "z", std::nullopt}, nullptr};
+
+  std::vector<uint8_t> first_bytes, second_bytes;
+  serialize(first, first_bytes);
+  serialize(second, second_bytes);
+
+  my_struct s;
+  std::error_code ec;
+  deserialize_into(s, first_bytes, ec);
+  REQUIRE((bool)ec == false);
+  REQUIRE(s.a == 1);
+  REQUIRE(s.b == first.b);
+  REQUIRE(s.c->values == first.c->values);
+
+  // the pointee is reused
+  const auto c = s.c.get();
+  deserialize_into(s, first_bytes, ec);
+  REQUIRE((bool)ec == false);
+  REQUIRE(s.c.get() == c);
+  REQUIRE(s.c->values == first.c->values);
+
+  deserialize_into(s, second_bytes, ec);
+  REQUIRE((bool)ec == false);
+  REQUIRE(s.a == 3);
+  REQUIRE(s.b == second.b);
+  REQUIRE(s.c == nullptr);
+}
+
+TEST_CASE("Deserialize into reuses capacity" *
+          test_suite("deserialize_into")) {
+  struct my_struct {
+    std::vector<int> a;
+    std::string b;
+    std::vector<std::vector<uint64_t>> c;
+    std::map<int, std::string> d;
+  };
+
+  my_struct large{std::vector<int>(1000, 5),
+                  std::string(1000, 'x'),
+                  {std::vector<uint64_t>(100, 1), std::vector<uint64_t>(100, 2)},
+                  {{1, std::string(100, 'a')}, {2, std::string(100, 'b')}}};
+
+  my_struct small{{1, 2}, "small", {{3}, {4}}, {{3, "c"}, {4, "d"}}};
+
+  std::vector<uint8_t> large_bytes, small_bytes;
+  serialize(large, large_bytes);
+  serialize(small, small_bytes);
+
+  my_struct s;
+  std::error_code ec;
+  deserialize_into(s, large_bytes, ec);
+  REQUIRE((bool)ec == false);
+
+  const auto a_data = s.a.data();
+  const auto b_capacity = s.b.capacity();
+  const auto c_data = s.c[1].data();
+  const auto d_node = &s.d.begin()->second;
+  const auto d_capacity = s.d.begin()->second.capacity();
+
+  deserialize_into(s, small_bytes, ec);
+  REQUIRE((bool)ec == false);
+  REQUIRE(s.a == small.a);
+  REQUIRE(s.b == small.b);
+  REQUIRE(s.c == small.c);
+  REQUIRE(s.d == small.d);
+
+  // no memory was reallocated
+  REQUIRE(s.a.data() == a_data);
+  REQUIRE(s.b.capacity() == b_capacity);
+  REQUIRE(s.c[1].data() == c_data);
+  REQUIRE(&s.d.begin()->second == d_node);
+  REQUIRE(s.d.begin()->second.capacity() == d_capacity);
+}
+
+TEST_CASE("Deserialize into resets fields missing from the input" *
+          test_suite("deserialize_into")) {
+  struct old_struct {
+    int a;
+  };
+
+  struct new_struct {
+    int a;
+    std::string b;
+    std::vector<int> c;
+  };
+
+  old_struct old_message{5};
+  std::vector<uint8_t> bytes;
+  serialize(old_message, bytes);
+
+  new_struct s{1, "stale", {1, 2, 3}};
+  std::error_code ec;
+  deserialize_into(s, bytes, ec);
+  REQUIRE((bool)ec == false);
+  REQUIRE(s.a == 5);
+  REQUIRE(s.b.empty());
+  REQUIRE(s.c.empty());
+}
+
+TEST_CASE("Deserialize into with options" * test_suite("deserialize_into")) {
+  struct my_struct {
+    uint32_t a;
+    std::vector<std::string> b;
+  };
+
+  constexpr auto OPTIONS = options::with_version | options::with_checksum |
+                           options::fixed_length_encoding;
+
+  my_struct first{1, {"a", "b", "c"}};
+  my_struct second{2, {"d"}};
+
+  std::array<uint8_t, 64> bytes;
+  my_struct s;
+  std::error_code ec;
+
+  auto size = serialize<OPTIONS>(first, bytes);
+  deserialize_into<OPTIONS>(s, bytes, size, ec);
+  REQUIRE((bool)ec == false);
+  REQUIRE(s.a == 1);
+  REQUIRE(s.b == first.b);
+
+  size = serialize<OPTIONS>(second, bytes);
+  deserialize_into<OPTIONS>(s, bytes, size, ec);
+  REQUIRE((bool)ec == false);
+  REQUIRE(s.a == 2);
+  REQUIRE(s.b == second.b);
+
+  // corrupted input leaves s as it was
+  bytes[5] ^= 0xff;
+  deserialize_into<OPTIONS>(s, bytes, size, ec);
+  REQUIRE((bool)ec == true);
+  REQUIRE(ec.value() == static_cast<int>(std::errc::bad_message));
+  REQUIRE(s.a == 2);
+  REQUIRE(s.b == second.b);
+}
+
+TEST_CASE("Deserialize into variant and array elements in place" *
+          test_suite("deserialize_into")) {
+  struct my_struct {
+    std::variant<int, std::string> a;
+    std::array<std::string, 2> b;
+    std::map<int, std::variant<std::string, std::vector<int>>> c;
+  };
+
+  my_struct first{std::string(100, 'a'),
+                  {std::string(100, 'b'), std::string(100, 'c')},
+                  {{1, std::string(100, 'd')}, {2, std::vector<int>{1, 2}}}};
+  my_struct second{std::string("e"), {"f", "g"}, {{1, "h"}, {2, "i"}}};
+
+  std::vector<uint8_t> first_bytes, second_bytes;
+  serialize(first, first_bytes);
+  serialize(second, second_bytes);
+
+  my_struct s;
+  std::error_code ec;
+  deserialize_into(s, first_bytes, ec);
+  REQUIRE((bool)ec == false);
+  REQUIRE(s.a == first.a);
+  REQUIRE(s.b == first.b);
+  REQUIRE(s.c == first.c);
+
+  const auto a_capacity = std::get<1>(s.a).capacity();
+  const auto b_capacity = s.b[1].capacity();
+  const auto c_capacity = std::get<0>(s.c[1]).capacity();
+
+  deserialize_into(s, second_bytes, ec);
+  REQUIRE((bool)ec == false);
+  REQUIRE(s.a == second.a);
+  REQUIRE(s.b == second.b);
+  REQUIRE(s.c == second.c);
+
+  // the strings were decoded into the existing values
+  REQUIRE(std::get<1>(s.a).capacity() == a_capacity);
+  REQUIRE(s.b[1].capacity() == b_capacity);
+  REQUIRE(std::get<0>(s.c[1]).capacity() == c_capacity);
+
+  // switching alternatives still works
+  deserialize_into(s, first_bytes, ec);
+  REQUIRE((bool)ec == false);
+  REQUIRE(s.c == first.c);
+}
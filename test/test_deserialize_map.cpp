@@ -73,4 +73,63 @@ TEST_CASE("Deserialize unordered_map<string, vector<int>>" *
     REQUIRE(
         (result.value.at("x") == std::map<int, double>{{3, 4.4}, {4, 5.5}}));
   }
-}
\ No newline at end of file
+}
+TEST_CASE("Deserialize large map<int, int>" * test_suite("map")) {
+  struct my_struct {
+    std::map<int, int> a;
+    std::unordered_map<int, int> b;
+  };
+
+  my_struct s;
+  for (int i = 0; i < 100000; ++i) {
+    s.a[i * 3] = -i;
+    s.b[i * 3] = i;
+  }
+
+  std::vector<uint8_t> bytes;
+  serialize(s, bytes);
+
+  std::error_code ec;
+  auto result = deserialize<options::require_sorted_keys, my_struct>(bytes, ec);
+  REQUIRE((bool)ec == false);
+  REQUIRE(result.a == s.a);
+  REQUIRE(result.b == s.b);
+
+  // buckets were allocated up front
+  REQUIRE(result.b.bucket_count() * result.b.max_load_factor() >=
+          result.b.size());
+}
+
+TEST_CASE("Deserialize map with unsorted keys" * test_suite("map")) {
+  struct my_struct {
+    std::map<uint8_t, uint8_t> value;
+  };
+
+  {
+    // keys out of order
+    std::vector<uint8_t> bytes{2, 5, 1, 3, 2};
+
+    std::error_code ec;
+    auto result = deserialize<my_struct>(bytes, ec);
+    REQUIRE((bool)ec == false);
+    REQUIRE((result.value == std::map<uint8_t, uint8_t>{{3, 2}, {5, 1}}));
+
+    deserialize<options::require_sorted_keys, my_struct>(bytes, ec);
+    REQUIRE((bool)ec == true);
+    REQUIRE(ec.value() == static_cast<int>(std::errc::illegal_byte_sequence));
+  }
+
+  {
+    // duplicate key
+    std::vector<uint8_t> bytes{2, 5, 1, 5, 2};
+
+    std::error_code ec;
+    auto result = deserialize<my_struct>(bytes, ec);
+    REQUIRE((bool)ec == false);
+    REQUIRE((result.value == std::map<uint8_t, uint8_t>{{5, 1}}));
+
+    deserialize<options::require_sorted_keys, my_struct>(bytes, ec);
+    REQUIRE((bool)ec == true);
+    REQUIRE(ec.value() == static_cast<int>(std::errc::illegal_byte_sequence));
+  }
+}
@@ -0,0 +1,128 @@
+#include <alpaca/alpaca.h>
+#include <doctest.hpp>
+using namespace alpaca;
+
+using doctest::test_suite;
+
+namespace {
+
+struct point {
+  float x;
+  float y;
+  float z;
+};
+
+struct pinned_struct {
+  uint8_t a;
+  int16_t b;
+  bool c;
+  double d;
+  point e;
+  std::array<uint16_t, 4> f;
+  std::string g;
+  char h;
+  uint64_t i;
+  std::vector<int> j;
+  uint32_t k;
+};
+
+pinned_struct make_pinned_struct() {
+  return {5,   -300, true, 3.5, {1, 2, 3}, {{4, 5, 6, 7}}, "pinned", 'x',
+          123, {-1, 2}, 0xffffffff};
+}
+
+void check_pinned_struct(const pinned_struct &s) {
+  REQUIRE(s.a == 5);
+  REQUIRE(s.b == -300);
+  REQUIRE(s.c == true);
+  REQUIRE(s.d == 3.5);
+  REQUIRE(s.e.x == 1);
+  REQUIRE(s.e.y == 2);
+  REQUIRE(s.e.z == 3);
+  REQUIRE(s.f == std::array<uint16_t, 4>{4, 5, 6, 7});
+  REQUIRE(s.g == "pinned");
+  REQUIRE(s.h == 'x');
+  REQUIRE(s.i == 123);
+  REQUIRE(s.j == std::vector<int>{-1, 2});
+  REQUIRE(s.k == 0xffffffff);
+}
+
+} // namespace
+
+TEST_CASE("Deserialize with pinned schema" * test_suite("pinned_schema")) {
+  std::vector<uint8_t> bytes;
+  serialize(make_pinned_struct(), bytes);
+
+  std::error_code ec;
+  auto s = deserialize<options::pinned_schema, pinned_struct>(bytes, ec);
+  REQUIRE((bool)ec == false);
+  check_pinned_struct(s);
+}
+
+TEST_CASE("Deserialize with pinned schema and fixed length encoding" *
+          test_suite("pinned_schema")) {
+  constexpr auto O = options::fixed_length_encoding;
+
+  std::vector<uint8_t> bytes;
+  serialize<O>(make_pinned_struct(), bytes);
+
+  std::error_code ec;
+  auto s = deserialize<O | options::pinned_schema, pinned_struct>(bytes, ec);
+  REQUIRE((bool)ec == false);
+  check_pinned_struct(s);
+
+  // fields a through f take up a fixed number of bytes
+  REQUIRE(detail::fixed_wire_size<O, point>() == 12);
+  REQUIRE(detail::fixed_wire_size<O, uint64_t>() == 8);
+  REQUIRE(detail::fixed_wire_size<options::none, uint64_t>() == 0);
+  REQUIRE(detail::fixed_wire_size<O, std::string>() == 0);
+}
+
+TEST_CASE("Deserialize truncated input with pinned schema" *
+          test_suite("pinned_schema")) {
+  std::vector<uint8_t> bytes;
+  serialize(make_pinned_struct(), bytes);
+
+  for (std::size_t size = 1; size < bytes.size(); ++size) {
+    // missing fields are an error instead of being default initialized
+    std::error_code ec;
+    deserialize<options::pinned_schema, pinned_struct>(bytes, size, ec);
+    REQUIRE((bool)ec == true);
+
+    // and validation agrees
+    ec.clear();
+    REQUIRE(validate<pinned_struct, options::pinned_schema>(bytes, size,
+                                                            ec) == false);
+  }
+
+  // without the option, input that ends between two fields is accepted
+  struct older_struct {
+    uint8_t a;
+    int16_t b;
+  };
+  std::vector<uint8_t> older_bytes;
+  serialize(older_struct{5, -300}, older_bytes);
+
+  std::error_code ec;
+  auto s = deserialize<pinned_struct>(older_bytes, ec);
+  REQUIRE((bool)ec == false);
+  REQUIRE(s.b == -300);
+
+  s = deserialize<options::pinned_schema, pinned_struct>(older_bytes, ec);
+  REQUIRE(ec == std::errc::message_size);
+}
+
+TEST_CASE("Deserialize validated input with pinned schema" *
+          test_suite("pinned_schema")) {
+  constexpr auto O = options::pinned_schema;
+
+  std::vector<uint8_t> bytes;
+  serialize(make_pinned_struct(), bytes);
+
+  std::error_code ec;
+  REQUIRE(validate<pinned_struct, O>(bytes, ec));
+
+  auto s = deserialize<O | options::trusted_input, pinned_struct>(bytes, ec);
+  REQUIRE((bool)ec == false);
+  check_pinned_struct(s);
+}
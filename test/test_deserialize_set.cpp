@@ -26,4 +26,28 @@ TEST_CASE("Deserialize set<int>" * test_suite("map")) {
     REQUIRE(result.value.find(3) != result.value.end());
     REQUIRE(result.value.find(4) != result.value.end());
   }
-}
\ No newline at end of file
+}
+
+TEST_CASE("Deserialize set with unsorted values" * test_suite("map")) {
+  struct my_struct {
+    std::set<uint8_t> value;
+  };
+
+  std::vector<uint8_t> bytes{3, 1, 5, 3};
+
+  std::error_code ec;
+  auto result = deserialize<my_struct>(bytes, ec);
+  REQUIRE((bool)ec == false);
+  REQUIRE((result.value == std::set<uint8_t>{1, 3, 5}));
+
+  deserialize<options::require_sorted_keys, my_struct>(bytes, ec);
+  REQUIRE((bool)ec == true);
+  REQUIRE(ec.value() == static_cast<int>(std::errc::illegal_byte_sequence));
+
+  // sorted input is accepted
+  bytes = {3, 1, 3, 5};
+  ec = {};
+  result = deserialize<options::require_sorted_keys, my_struct>(bytes, ec);
+  REQUIRE((bool)ec == false);
+  REQUIRE((result.value == std::set<uint8_t>{1, 3, 5}));
+}
@@ -0,0 +1,155 @@
+#include <alpaca/alpaca.h>
+#include <doctest.hpp>
+#include <filesystem>
+using namespace alpaca;
+
+using doctest::test_suite;
+
+namespace {
+
+struct histogram {
+  std::vector<uint32_t> ids;
+  std::vector<uint64_t> counts;
+  std::string name;
+};
+
+histogram make_histogram() {
+  histogram h;
+  // values of every encoded length, more than 4 at a time
+  for (uint32_t i = 0; i < 100; ++i) {
+    h.ids.push_back(i * 0x01010101u >> (i % 32));
+    h.counts.push_back(uint64_t{i} << (i % 64));
+  }
+  h.ids.push_back(0xffffffff);
+  h.counts.push_back(std::numeric_limits<uint64_t>::max());
+  h.name = "histogram";
+  return h;
+}
+
+} // namespace
+
+TEST_CASE("Deserialize stream vbyte" * test_suite("stream_vbyte")) {
+  constexpr auto O = options::stream_vbyte;
+  const auto h = make_histogram();
+
+  std::vector<uint8_t> bytes;
+  serialize<O>(h, bytes);
+
+  std::error_code ec;
+  auto result = deserialize<O, histogram>(bytes, ec);
+  REQUIRE((bool)ec == false);
+  REQUIRE(result.ids == h.ids);
+  REQUIRE(result.counts == h.counts);
+  REQUIRE(result.name == h.name);
+
+  REQUIRE(validate<histogram, O>(bytes, ec));
+}
+
+TEST_CASE("Serialize stream vbyte" * test_suite("stream_vbyte")) {
+  struct my_struct {
+    std::vector<uint32_t> values;
+  };
+
+  std::vector<uint8_t> bytes;
+  serialize<options::stream_vbyte>(
+      my_struct{{1, 0x100, 0x10000, 0x1000000, 0}}, bytes);
+
+  // size, 2 control bytes, then 1 + 2 + 3 + 4 + 1 data bytes
+  REQUIRE(bytes.size() == 1 + 2 + 11);
+  REQUIRE(bytes[0] == 5);
+  REQUIRE(bytes[1] == 0xe4); // 0b11'10'01'00
+  REQUIRE(bytes[2] == 0x00);
+  REQUIRE(bytes[3] == 0x01);
+  REQUIRE(bytes[4] == 0x00);
+  REQUIRE(bytes[5] == 0x01);
+
+  // an empty vector is only its size
+  bytes.clear();
+  serialize<options::stream_vbyte>(my_struct{}, bytes);
+  REQUIRE(bytes.size() == 1);
+
+  std::error_code ec;
+  auto result = deserialize<options::stream_vbyte, my_struct>(bytes, ec);
+  REQUIRE((bool)ec == false);
+  REQUIRE(result.values.empty());
+}
+
+TEST_CASE("Deserialize truncated stream vbyte" * test_suite("stream_vbyte")) {
+  constexpr auto O = options::stream_vbyte;
+  struct my_struct {
+    std::vector<uint64_t> values;
+  };
+
+  std::vector<uint8_t> bytes;
+  serialize<O>(my_struct{{1, 1ull << 40, 5, 1ull << 63}}, bytes);
+
+  for (std::size_t size = 1; size < bytes.size(); ++size) {
+    std::error_code ec;
+    deserialize<O, my_struct>(bytes, size, ec);
+    REQUIRE((bool)ec == true);
+
+    ec.clear();
+    REQUIRE(validate<my_struct, O>(bytes, size, ec) == false);
+  }
+}
+
+TEST_CASE("Deserialize stream vbyte with an illegal length" *
+          test_suite("stream_vbyte")) {
+  constexpr auto O = options::stream_vbyte;
+  struct my_struct {
+    std::vector<uint64_t> values;
+  };
+
+  // one value, whose code is a length of 16 bytes
+  std::vector<uint8_t> bytes{1, 0x0f};
+  bytes.insert(bytes.end(), 16, 0xab);
+
+  std::error_code ec;
+  deserialize<O, my_struct>(bytes, ec);
+  REQUIRE(ec == std::errc::illegal_byte_sequence);
+
+  ec.clear();
+  REQUIRE(validate<my_struct, O>(bytes, ec) == false);
+  REQUIRE(ec == std::errc::illegal_byte_sequence);
+
+  // the same bytes, read from a file
+  const auto filename = "test_stream_vbyte_illegal.bin";
+  {
+    std::ofstream os(filename, std::ios::out | std::ios::binary);
+    os.write(reinterpret_cast<const char *>(bytes.data()),
+             static_cast<std::streamsize>(bytes.size()));
+  }
+  std::ifstream is(filename, std::ios::in | std::ios::binary);
+  ec.clear();
+  deserialize<O, my_struct>(is, bytes.size(), ec);
+  is.close();
+  std::filesystem::remove(filename);
+  REQUIRE(ec == std::errc::illegal_byte_sequence);
+}
+
+TEST_CASE("Deserialize stream vbyte from file" * test_suite("stream_vbyte")) {
+  constexpr auto O = options::stream_vbyte;
+  const auto h = make_histogram();
+
+  const auto filename = "test_stream_vbyte.bin";
+  {
+    std::ofstream os;
+    os.open(filename, std::ios::out | std::ios::binary);
+    auto bytes_written = serialize<O>(h, os);
+    os.close();
+    REQUIRE(bytes_written > 0);
+  }
+
+  std::ifstream is;
+  is.open(filename, std::ios::in | std::ios::binary);
+  auto size = std::filesystem::file_size(filename);
+  std::error_code ec;
+  auto result = deserialize<O, histogram>(is, size, ec);
+  is.close();
+  std::filesystem::remove(filename);
+
+  REQUIRE((bool)ec == false);
+  REQUIRE(result.ids == h.ids);
+  REQUIRE(result.counts == h.counts);
+  REQUIRE(result.name == h.name);
+}
@@ -0,0 +1,184 @@
+#include <alpaca/alpaca.h>
+#include <doctest.hpp>
+using namespace alpaca;
+
+using doctest::test_suite;
+
+TEST_CASE("Deserialize string_view" * test_suite("string_view")) {
+  struct my_struct {
+    std::string_view name;
+    int value;
+  };
+
+  std::string name = "Hello World";
+  my_struct s{name, 5};
+
+  std::vector<uint8_t> bytes;
+  auto bytes_written = serialize(s, bytes);
+  REQUIRE(bytes_written == 13);
+
+  std::error_code ec;
+  auto recovered = deserialize<my_struct>(bytes, ec);
+  REQUIRE((bool)ec == false);
+  REQUIRE(recovered.name == "Hello World");
+  REQUIRE(recovered.value == 5);
+
+  // points into bytes instead of owning a copy
+  REQUIRE(reinterpret_cast<const uint8_t *>(recovered.name.data()) ==
+          bytes.data() + 1);
+}
+
+TEST_CASE("Deserialize string_view from std::string" *
+          test_suite("string_view")) {
+  struct owning {
+    std::string a;
+    std::vector<std::string> b;
+  };
+
+  struct borrowing {
+    std::string_view a;
+    std::vector<std::string_view> b;
+  };
+
+  owning s{"abc", {"", "defg", "hi"}};
+
+  std::vector<uint8_t> bytes;
+  serialize(s, bytes);
+
+  std::error_code ec;
+  auto recovered = deserialize<borrowing>(bytes, ec);
+  REQUIRE((bool)ec == false);
+  REQUIRE(recovered.a == "abc");
+  REQUIRE(recovered.b.size() == 3);
+  REQUIRE(recovered.b[0].empty());
+  REQUIRE(recovered.b[1] == "defg");
+  REQUIRE(recovered.b[2] == "hi");
+}
+
+TEST_CASE("Deserialize string_view with options" *
+          test_suite("string_view")) {
+  struct owning {
+    std::string a;
+  };
+
+  struct borrowing {
+    std::string_view a;
+  };
+
+  {
+    constexpr auto OPTIONS = options::with_checksum;
+
+    owning s{"checksum"};
+
+    std::vector<uint8_t> bytes;
+    serialize<OPTIONS>(s, bytes);
+
+    std::error_code ec;
+    auto recovered = deserialize<OPTIONS, borrowing>(bytes, ec);
+    REQUIRE((bool)ec == false);
+    REQUIRE(recovered.a == "checksum");
+  }
+
+  {
+    constexpr auto OPTIONS = options::with_version | options::big_endian;
+
+    std::string value = "version";
+    borrowing s{value};
+
+    std::vector<uint8_t> bytes;
+    serialize<OPTIONS>(s, bytes);
+
+    std::error_code ec;
+    auto recovered = deserialize<OPTIONS, borrowing>(bytes, ec);
+    REQUIRE((bool)ec == false);
+    REQUIRE(recovered.a == "version");
+  }
+}
+
+TEST_CASE("Deserialize string_view from array" * test_suite("string_view")) {
+  struct my_struct {
+    std::string_view a;
+    std::string_view b;
+  };
+
+  std::array<uint8_t, 8> bytes{3, 'a', 'b', 'c', 2, 'd', 'e', 0};
+
+  std::error_code ec;
+  auto recovered = deserialize<my_struct>(bytes, 7, ec);
+  REQUIRE((bool)ec == false);
+  REQUIRE(recovered.a == "abc");
+  REQUIRE(recovered.b == "de");
+}
+
+TEST_CASE("Deserialize string_view larger than input" *
+          test_suite("string_view")) {
+  struct my_struct {
+    std::string_view a;
+  };
+
+  std::vector<uint8_t> bytes{10, 'a', 'b', 'c'};
+
+  std::error_code ec;
+  deserialize<my_struct>(bytes, ec);
+  REQUIRE((bool)ec == true);
+  REQUIRE(ec.value() == static_cast<int>(std::errc::value_too_large));
+}
+
+#ifdef __cpp_lib_span
+TEST_CASE("Deserialize span" * test_suite("string_view")) {
+  struct owning {
+    std::vector<uint32_t> values;
+  };
+
+  struct borrowing {
+    std::span<const uint32_t> values;
+  };
+
+  owning s{{1, 2, 3, 0xffffffff}};
+
+  constexpr auto OPTIONS = options::fixed_length_encoding;
+
+  std::vector<uint8_t> bytes;
+  serialize<OPTIONS>(s, bytes);
+  // length prefix is 4 bytes, so the elements are aligned
+  REQUIRE(bytes.size() == 4 + 4 * 4);
+
+  std::error_code ec;
+  auto recovered = deserialize<OPTIONS, borrowing>(bytes, ec);
+  REQUIRE((bool)ec == false);
+  REQUIRE(recovered.values.size() == 4);
+  REQUIRE(recovered.values[0] == 1);
+  REQUIRE(recovered.values[3] == 0xffffffff);
+
+  // and back again
+  std::vector<uint8_t> bytes2;
+  serialize<OPTIONS>(recovered, bytes2);
+  REQUIRE(bytes2 == bytes);
+}
+
+TEST_CASE("Deserialize misaligned span" * test_suite("string_view")) {
+  struct owning {
+    uint8_t tag;
+    std::vector<uint32_t> values;
+  };
+
+  struct borrowing {
+    uint8_t tag;
+    std::span<const uint32_t> values;
+  };
+
+  constexpr auto OPTIONS = options::fixed_length_encoding;
+
+  owning s{7, {1, 2, 3}};
+
+  // the tag puts the elements at an odd address
+  std::vector<uint8_t> bytes;
+  serialize<OPTIONS>(s, bytes);
+
+  std::error_code ec;
+  auto recovered = deserialize<OPTIONS, borrowing>(bytes, ec);
+  REQUIRE((bool)ec == true);
+  REQUIRE(ec.value() == static_cast<int>(std::errc::bad_address));
+  REQUIRE(recovered.values.empty());
+}
+#endif
@@ -326,4 +326,42 @@ TEST_CASE("Deserialize unsigned integer types" *
     REQUIRE(result.g == 12345678);
     REQUIRE(result.h == 5294967295);
   }
-}
\ No newline at end of file
+}
+
+TEST_CASE("Deserialize uint64_t across varint lengths" *
+          test_suite("unsigned_integer")) {
+  struct my_struct {
+    std::vector<uint64_t> values;
+    uint32_t last;
+  };
+
+  // the first and last value of every encoded length
+  std::vector<uint64_t> values;
+  for (std::size_t bits = 7; bits < 64; bits += 7) {
+    values.push_back((uint64_t{1} << bits) - 1);
+    values.push_back(uint64_t{1} << bits);
+  }
+  values.push_back(0);
+  values.push_back(std::numeric_limits<uint64_t>::max());
+
+  std::vector<uint8_t> bytes;
+  serialize(my_struct{values, 0xffffffff}, bytes);
+
+  std::error_code ec;
+  auto result = deserialize<my_struct>(bytes, ec);
+  REQUIRE((bool)ec == false);
+  REQUIRE(result.values == values);
+  REQUIRE(result.last == 0xffffffff);
+
+  // each value on its own, so that some are decoded near the end of input
+  for (auto value : values) {
+    struct single {
+      uint64_t value;
+    };
+    bytes.clear();
+    serialize(single{value}, bytes);
+    auto s = deserialize<single>(bytes, ec);
+    REQUIRE((bool)ec == false);
+    REQUIRE(s.value == value);
+  }
+}
@@ -28,4 +28,55 @@ TEST_CASE("Deserialize std::u16string" * test_suite("string")) {
     REQUIRE(result.example == u"This is a string");
     REQUIRE(result.greeting == U"Hello, 世界");
   }
-}
\ No newline at end of file
+}
+
+TEST_CASE("Deserialize std::u16string with options" * test_suite("string")) {
+  struct my_struct {
+    std::u16string example;
+    std::u32string greeting;
+    std::string empty;
+  };
+
+  constexpr auto OPTIONS = options::big_endian | options::with_checksum;
+
+  std::array<uint8_t, 128> bytes;
+  std::size_t bytes_written = 0;
+
+  // serialize
+  {
+    my_struct s{u"This is a string", U"Hello, 世界", ""};
+    bytes_written = serialize<OPTIONS>(s, bytes);
+  }
+
+  // deserialize
+  {
+    std::error_code ec;
+    auto result = deserialize<OPTIONS, my_struct>(bytes, bytes_written, ec);
+    REQUIRE((bool)ec == false);
+    REQUIRE(result.example == u"This is a string");
+    REQUIRE(result.greeting == U"Hello, 世界");
+    REQUIRE(result.empty.empty());
+  }
+}
+
+TEST_CASE("Deserialize std::filesystem::path" * test_suite("string")) {
+  struct my_struct {
+    std::filesystem::path path;
+  };
+
+  std::vector<uint8_t> bytes;
+
+  // serialize
+  {
+    my_struct s{std::filesystem::path{"/usr/local/include/alpaca.h"}};
+    serialize(s, bytes);
+  }
+
+  // deserialize
+  {
+    std::error_code ec;
+    auto result = deserialize<my_struct>(bytes, ec);
+    REQUIRE((bool)ec == false);
+    REQUIRE(result.path == std::filesystem::path{"/usr/local/include/alpaca.h"});
+  }
+}
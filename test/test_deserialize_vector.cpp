@@ -116,4 +116,68 @@ TEST_CASE("Deserialize vector<nested_struct>" * test_suite("vector")) {
     REQUIRE(result.nested_values[1].value == 2);
     REQUIRE(result.nested_values[2].value == 3);
   }
-}
\ No newline at end of file
+}
+
+TEST_CASE("Deserialize vector sizes the container once" * test_suite("vector")) {
+  struct my_struct {
+    std::vector<std::string> names;
+    std::vector<std::vector<int>> values;
+  };
+
+  std::vector<uint8_t> bytes;
+
+  {
+    my_struct s;
+    for (int i = 0; i < 1000; ++i) {
+      s.names.push_back("name " + std::to_string(i));
+      s.values.push_back({i, -i, i * 1000});
+    }
+    serialize(s, bytes);
+  }
+
+  {
+    std::error_code ec;
+    auto result = deserialize<my_struct>(bytes, ec);
+    REQUIRE((bool)ec == false);
+    REQUIRE(result.names.size() == 1000);
+    REQUIRE(result.values.size() == 1000);
+    REQUIRE(result.names[999] == "name 999");
+    REQUIRE((result.values[999] == std::vector<int>{999, -999, 999000}));
+
+    // decoding the same message again into result does not reallocate
+    const auto *names = result.names.data();
+    const auto *values = result.values.data();
+    deserialize_into(result, bytes, ec);
+    REQUIRE((bool)ec == false);
+    REQUIRE(result.names.data() == names);
+    REQUIRE(result.values.data() == values);
+    REQUIRE(result.names[999] == "name 999");
+  }
+}
+
+TEST_CASE("Deserialize vector<bool>" * test_suite("vector")) {
+  struct my_struct {
+    std::vector<bool> flags;
+    int after;
+  };
+
+  for (std::size_t size : {0, 1, 7, 8, 9, 63, 64, 65, 130, 1000}) {
+    my_struct s;
+    for (std::size_t i = 0; i < size; ++i) {
+      s.flags.push_back(i % 3 == 0 || i % 7 == 0);
+    }
+    s.after = -5;
+
+    std::vector<uint8_t> bytes;
+    serialize(s, bytes);
+    // size, 8 values to a byte, then 1 byte for `after`
+    REQUIRE(bytes.size() == (size < 128 ? 1 : 2) + (size + 7) / 8 + 1);
+
+    std::error_code ec;
+    REQUIRE(validate<my_struct>(bytes, ec));
+    auto result = deserialize<my_struct>(bytes, ec);
+    REQUIRE((bool)ec == false);
+    REQUIRE(result.flags == s.flags);
+    REQUIRE(result.after == -5);
+  }
+}
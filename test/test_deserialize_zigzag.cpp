@@ -0,0 +1,131 @@
+#include <alpaca/alpaca.h>
+#include <doctest.hpp>
+#include <filesystem>
+using namespace alpaca;
+
+using doctest::test_suite;
+
+namespace {
+
+struct coordinates {
+  int32_t x;
+  int64_t y;
+  std::vector<int64_t> deltas;
+  std::map<int32_t, int32_t> offsets;
+  uint32_t count;
+};
+
+coordinates make_coordinates() {
+  coordinates c;
+  c.x = -3;
+  c.y = std::numeric_limits<int64_t>::min();
+  for (std::size_t bits = 0; bits < 63; bits += 7) {
+    c.deltas.push_back(int64_t{1} << bits);
+    c.deltas.push_back(-(int64_t{1} << bits));
+  }
+  c.deltas.push_back(std::numeric_limits<int64_t>::max());
+  c.deltas.push_back(std::numeric_limits<int64_t>::min());
+  c.offsets = {{std::numeric_limits<int32_t>::min(), -1},
+               {0, std::numeric_limits<int32_t>::max()}};
+  c.count = 0xffffffff;
+  return c;
+}
+
+void check_coordinates(const coordinates &c) {
+  const auto expected = make_coordinates();
+  REQUIRE(c.x == expected.x);
+  REQUIRE(c.y == expected.y);
+  REQUIRE(c.deltas == expected.deltas);
+  REQUIRE(c.offsets == expected.offsets);
+  REQUIRE(c.count == expected.count);
+}
+
+} // namespace
+
+TEST_CASE("Serialize zigzag" * test_suite("zigzag")) {
+  struct my_struct {
+    int32_t a;
+    int32_t b;
+    int64_t c;
+    int64_t d;
+  };
+
+  std::vector<uint8_t> bytes;
+  serialize<options::zigzag>(my_struct{0, -1, 1, -65}, bytes);
+  REQUIRE(bytes.size() == 5);
+  REQUIRE(bytes[0] == 0x00);
+  REQUIRE(bytes[1] == 0x01);
+  REQUIRE(bytes[2] == 0x02);
+  // 129 = 0b1'0000001
+  REQUIRE(bytes[3] == 0x81);
+  REQUIRE(bytes[4] == 0x01);
+
+  REQUIRE(detail::zigzag_encode<int64_t>(std::numeric_limits<int64_t>::min()) ==
+          std::numeric_limits<uint64_t>::max());
+  REQUIRE(detail::zigzag_decode<int32_t>(0xfffffffe) ==
+          std::numeric_limits<int32_t>::max());
+}
+
+TEST_CASE("Deserialize zigzag" * test_suite("zigzag")) {
+  constexpr auto O = options::zigzag;
+
+  std::vector<uint8_t> bytes;
+  serialize<O>(make_coordinates(), bytes);
+
+  std::error_code ec;
+  auto c = deserialize<O, coordinates>(bytes, ec);
+  REQUIRE((bool)ec == false);
+  check_coordinates(c);
+
+  REQUIRE(validate<coordinates, O>(bytes, ec));
+
+  // the most negative values also round-trip without the option
+  bytes.clear();
+  serialize(make_coordinates(), bytes);
+  c = deserialize<coordinates>(bytes, ec);
+  REQUIRE((bool)ec == false);
+  check_coordinates(c);
+}
+
+TEST_CASE("Deserialize truncated zigzag" * test_suite("zigzag")) {
+  constexpr auto O = options::zigzag;
+  struct my_struct {
+    int64_t a;
+  };
+
+  std::vector<uint8_t> bytes;
+  serialize<O>(my_struct{std::numeric_limits<int64_t>::min()}, bytes);
+  REQUIRE(bytes.size() == 10);
+
+  std::error_code ec;
+  deserialize<O, my_struct>(bytes, 5, ec);
+  REQUIRE(ec == std::errc::message_size);
+
+  ec.clear();
+  REQUIRE(validate<my_struct, O>(bytes, 5, ec) == false);
+  REQUIRE(ec == std::errc::message_size);
+}
+
+TEST_CASE("Deserialize zigzag from file" * test_suite("zigzag")) {
+  constexpr auto O = options::zigzag;
+
+  const auto filename = "test_zigzag.bin";
+  {
+    std::ofstream os;
+    os.open(filename, std::ios::out | std::ios::binary);
+    auto bytes_written = serialize<O>(make_coordinates(), os);
+    os.close();
+    REQUIRE(bytes_written > 0);
+  }
+
+  std::ifstream is;
+  is.open(filename, std::ios::in | std::ios::binary);
+  auto size = std::filesystem::file_size(filename);
+  std::error_code ec;
+  auto c = deserialize<O, coordinates>(is, size, ec);
+  is.close();
+  std::filesystem::remove(filename);
+
+  REQUIRE((bool)ec == false);
+  check_coordinates(c);
+}
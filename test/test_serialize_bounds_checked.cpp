@@ -0,0 +1,84 @@
+#include <alpaca/alpaca.h>
+#include <doctest.hpp>
+using namespace alpaca;
+
+using doctest::test_suite;
+
+namespace {
+
+struct packet {
+  uint32_t id;
+  std::string payload;
+  std::vector<float> values;
+};
+
+} // namespace
+
+TEST_CASE("Serialize into pointer and capacity" * test_suite("bounds_checked")) {
+  packet p{5, "Hello World", {1.0f, 2.0f, 3.0f}};
+  const auto required_size = serialized_size(p);
+
+  std::vector<uint8_t> buffer(required_size);
+  std::error_code ec;
+  auto bytes_written = serialize(p, buffer.data(), buffer.size(), ec);
+  REQUIRE((bool)ec == false);
+  REQUIRE(bytes_written == required_size);
+
+  auto recovered = deserialize<packet>(buffer, ec);
+  REQUIRE((bool)ec == false);
+  REQUIRE(recovered.id == p.id);
+  REQUIRE(recovered.payload == p.payload);
+  REQUIRE(recovered.values == p.values);
+}
+
+TEST_CASE("Serialize error - no_buffer_space" * test_suite("bounds_checked")) {
+  packet p{5, "Hello World", {1.0f, 2.0f, 3.0f}};
+  const auto required_size = serialized_size(p);
+
+  // one byte too small, nothing is written
+  std::vector<uint8_t> buffer(required_size - 1, 0xab);
+  std::error_code ec;
+  auto result = serialize(p, buffer.data(), buffer.size(), ec);
+  REQUIRE((bool)ec == true);
+  REQUIRE(ec.value() == static_cast<int>(std::errc::no_buffer_space));
+  REQUIRE(result == required_size);
+  for (auto &b : buffer) {
+    REQUIRE(b == 0xab);
+  }
+}
+
+TEST_CASE("Serialize into fixed-size slots" * test_suite("bounds_checked")) {
+  constexpr auto OPTIONS = options::with_checksum;
+
+  std::array<uint8_t, 32> slot;
+  uint8_t c_array[32];
+
+  {
+    packet p{1, "small", {}};
+    std::error_code ec;
+    auto bytes_written = serialize<OPTIONS>(p, slot, ec);
+    REQUIRE((bool)ec == false);
+    REQUIRE(bytes_written == serialized_size<OPTIONS>(p));
+
+    auto recovered = deserialize<OPTIONS, packet>(slot, bytes_written, ec);
+    REQUIRE((bool)ec == false);
+    REQUIRE(recovered.payload == "small");
+
+    bytes_written = serialize<OPTIONS>(p, c_array, ec);
+    REQUIRE((bool)ec == false);
+    REQUIRE(bytes_written == serialized_size<OPTIONS>(p));
+  }
+
+  {
+    packet p{2, "this payload does not fit in a 32 byte slot", {}};
+    std::error_code ec;
+    auto result = serialize<OPTIONS>(p, slot, ec);
+    REQUIRE(ec.value() == static_cast<int>(std::errc::no_buffer_space));
+    REQUIRE(result == serialized_size<OPTIONS>(p));
+
+    ec.clear();
+    result = serialize(p, c_array, ec);
+    REQUIRE(ec.value() == static_cast<int>(std::errc::no_buffer_space));
+    REQUIRE(result == serialized_size(p));
+  }
+}
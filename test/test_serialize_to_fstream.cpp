@@ -62,4 +62,68 @@ TEST_CASE("Serialize complex struct to fstream with options" *
   REQUIRE(bytes_written == expected_size);
   REQUIRE(std::filesystem::file_size("tmp4.bin") == expected_size);
   std::filesystem::remove("tmp4.bin");
-}
\ No newline at end of file
+}
+TEST_CASE("Serialize large struct to fstream" * test_suite("fstream")) {
+  struct my_struct {
+    std::vector<std::string> a;
+    std::vector<float> b;
+  };
+
+  my_struct s;
+  for (int i = 0; i < 10000; ++i) {
+    s.a.push_back("log entry " + std::to_string(i));
+  }
+  s.b.resize(100000, 3.14f);
+
+  std::vector<uint8_t> expected;
+  serialize(s, expected);
+
+  // Serialize to file
+  std::ofstream os;
+  os.open("tmp5.bin", std::ios::out | std::ios::binary);
+  auto bytes_written = serialize(s, os);
+  os.close();
+  REQUIRE(bytes_written == expected.size());
+  REQUIRE(std::filesystem::file_size("tmp5.bin") == expected.size());
+
+  std::ifstream is;
+  is.open("tmp5.bin", std::ios::in | std::ios::binary);
+  std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(is)),
+                             std::istreambuf_iterator<char>());
+  is.close();
+  REQUIRE(bytes == expected);
+  std::filesystem::remove("tmp5.bin");
+}
+
+TEST_CASE("Serialize to fstream with buffered_ostream_sink" *
+          test_suite("fstream")) {
+  struct my_struct {
+    std::string a;
+    std::vector<uint16_t> b;
+  };
+
+  my_struct s{"Hello World", {1, 2, 3, 4, 5, 6, 7, 8}};
+
+  std::vector<uint8_t> expected;
+  serialize(s, expected);
+
+  // a small block size forces both buffered and direct writes
+  std::ofstream os;
+  os.open("tmp6.bin", std::ios::out | std::ios::binary);
+  {
+    buffered_ostream_sink sink{os, 8};
+    auto bytes_written = serialize(s, sink);
+    REQUIRE(bytes_written == expected.size());
+    REQUIRE(sink.position() == expected.size());
+  }
+  os.close();
+  REQUIRE(std::filesystem::file_size("tmp6.bin") == expected.size());
+
+  std::ifstream is;
+  is.open("tmp6.bin", std::ios::in | std::ios::binary);
+  std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(is)),
+                             std::istreambuf_iterator<char>());
+  is.close();
+  REQUIRE(bytes == expected);
+  std::filesystem::remove("tmp6.bin");
+}
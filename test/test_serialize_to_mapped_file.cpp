@@ -0,0 +1,105 @@
+#include <alpaca/alpaca.h>
+#include <doctest.hpp>
+#include <filesystem>
+using namespace alpaca;
+
+using doctest::test_suite;
+
+#ifdef ALPACA_HAS_MAPPED_FILE
+
+TEST_CASE("Serialize complex struct to mapped_file_sink" *
+          test_suite("mapped_file")) {
+  struct my_struct {
+    int a;
+    bool b;
+    char c;
+    std::string d;
+    std::vector<uint64_t> e;
+    std::map<std::string, std::array<uint8_t, 3>> f;
+  };
+
+  my_struct s{5,
+              true,
+              'a',
+              "Hello World",
+              {6, 5, 4, 3, 2, 1},
+              {{"abc", {1, 2, 3}}, {"def", {4, 5, 6}}}};
+
+  constexpr auto OPTIONS = options::with_version | options::with_checksum;
+
+  std::vector<uint8_t> expected;
+  serialize<OPTIONS>(s, expected);
+
+  {
+    std::error_code ec;
+    mapped_file_sink sink("tmp14.bin", ec);
+    REQUIRE((bool)ec == false);
+    auto bytes_written = serialize<OPTIONS>(s, sink);
+    sink.close(ec);
+    REQUIRE((bool)ec == false);
+    REQUIRE(bytes_written == expected.size());
+  }
+
+  // the file is truncated to the bytes written
+  REQUIRE(std::filesystem::file_size("tmp14.bin") == expected.size());
+
+  std::error_code ec;
+  mapped_file file("tmp14.bin", ec);
+  REQUIRE((bool)ec == false);
+  REQUIRE(std::memcmp(file.data(), expected.data(), expected.size()) == 0);
+
+  auto recovered = deserialize<OPTIONS, my_struct>(file, ec);
+  REQUIRE((bool)ec == false);
+  REQUIRE(recovered.d == s.d);
+  REQUIRE(recovered.f == s.f);
+  file.close();
+  std::filesystem::remove("tmp14.bin");
+}
+
+TEST_CASE("Serialize consecutive objects to mapped_file_sink" *
+          test_suite("mapped_file")) {
+  struct my_struct {
+    std::vector<float> values;
+  };
+
+  my_struct s1{std::vector<float>(300000, 1.5f)};
+  my_struct s2{std::vector<float>(5, 2.5f)};
+
+  std::size_t size1 = 0, size2 = 0;
+  {
+    std::error_code ec;
+    mapped_file_sink sink("tmp15.bin", ec);
+    REQUIRE((bool)ec == false);
+    size1 = serialize(s1, sink);
+    size2 = serialize(s2, sink);
+    REQUIRE(sink.position() == size1 + size2);
+    // closed on destruction
+  }
+
+  REQUIRE(std::filesystem::file_size("tmp15.bin") == size1 + size2);
+
+  std::error_code ec;
+  mapped_file file("tmp15.bin", ec);
+  REQUIRE((bool)ec == false);
+  auto recovered1 = deserialize<my_struct>(file, size1, ec);
+  REQUIRE((bool)ec == false);
+  REQUIRE(recovered1.values == s1.values);
+
+  std::size_t byte_index = size1;
+  std::size_t end_index = size1 + size2;
+  my_struct recovered2;
+  deserialize(recovered2, file, byte_index, end_index, ec);
+  REQUIRE((bool)ec == false);
+  REQUIRE(recovered2.values == s2.values);
+  file.close();
+  std::filesystem::remove("tmp15.bin");
+}
+
+TEST_CASE("mapped_file_sink error - invalid path" *
+          test_suite("mapped_file")) {
+  std::error_code ec;
+  mapped_file_sink sink("does/not/exist.bin", ec);
+  REQUIRE(ec == std::errc::no_such_file_or_directory);
+}
+
+#endif
@@ -0,0 +1,158 @@
+#include <alpaca/alpaca.h>
+#include <doctest.hpp>
+#include <sstream>
+using namespace alpaca;
+
+using doctest::test_suite;
+
+namespace {
+
+struct my_struct {
+  uint16_t a;
+  std::string b;
+  std::vector<float> c;
+  std::map<std::string, int> d;
+};
+
+my_struct make_struct() {
+  return {0x0102, "Hello World", {1.0f, 2.5f, -3.0f}, {{"x", 1}, {"y", -2}}};
+}
+
+void check_struct(const my_struct &recovered) {
+  const auto expected = make_struct();
+  REQUIRE(recovered.a == expected.a);
+  REQUIRE(recovered.b == expected.b);
+  REQUIRE(recovered.c == expected.c);
+  REQUIRE(recovered.d == expected.d);
+}
+
+// counts the calls made by serialize
+struct counting_sink {
+  std::vector<uint8_t> bytes;
+  std::size_t num_writes{0};
+  std::size_t num_reserves{0};
+  std::size_t reserved{0};
+
+  void write(const uint8_t *data, std::size_t size) {
+    bytes.insert(bytes.end(), data, data + size);
+    ++num_writes;
+  }
+
+  void reserve(std::size_t size) {
+    ++num_reserves;
+    reserved += size;
+  }
+
+  std::size_t position() const { return bytes.size(); }
+};
+
+} // namespace
+
+TEST_CASE("Serialize to container_sink" * test_suite("sink")) {
+  std::vector<uint8_t> expected;
+  serialize(make_struct(), expected);
+
+  {
+    std::string str;
+    container_sink<std::string> sink{str};
+    auto bytes_written = serialize(make_struct(), sink);
+    REQUIRE(bytes_written == expected.size());
+    REQUIRE(sink.position() == expected.size());
+    REQUIRE(str.size() == expected.size());
+    REQUIRE(std::memcmp(str.data(), expected.data(), expected.size()) == 0);
+  }
+
+  {
+    std::vector<std::byte> bytes{std::byte{0xff}};
+    container_sink<std::vector<std::byte>> sink{bytes};
+    auto bytes_written = serialize(make_struct(), sink);
+    REQUIRE(bytes_written == expected.size());
+    REQUIRE(sink.position() == expected.size());
+    REQUIRE(bytes.size() == expected.size() + 1);
+    REQUIRE(bytes[0] == std::byte{0xff});
+    REQUIRE(std::memcmp(bytes.data() + 1, expected.data(), expected.size()) ==
+            0);
+  }
+}
+
+TEST_CASE("Serialize to std::string and std::vector<std::byte>" *
+          test_suite("sink")) {
+  std::vector<uint8_t> expected;
+  serialize(make_struct(), expected);
+
+  std::string str;
+  REQUIRE(serialize(make_struct(), str) == expected.size());
+  REQUIRE(std::memcmp(str.data(), expected.data(), expected.size()) == 0);
+
+  std::vector<std::byte> bytes;
+  REQUIRE(serialize(make_struct(), bytes) == expected.size());
+  REQUIRE(std::memcmp(bytes.data(), expected.data(), expected.size()) == 0);
+}
+
+TEST_CASE("Serialize to span_sink" * test_suite("sink")) {
+  const auto s = make_struct();
+  std::vector<uint8_t> buffer(serialized_size(s));
+
+  span_sink sink{buffer.data(), buffer.size()};
+  auto bytes_written = serialize(s, sink);
+  REQUIRE(bytes_written == buffer.size());
+  REQUIRE(sink.position() == buffer.size());
+
+  std::error_code ec;
+  auto recovered = deserialize<my_struct>(buffer, ec);
+  REQUIRE((bool)ec == false);
+  check_struct(recovered);
+}
+
+TEST_CASE("Serialize to ostream_sink" * test_suite("sink")) {
+  std::ostringstream stream;
+  ostream_sink sink{stream};
+  auto bytes_written = serialize(make_struct(), sink);
+
+  const auto str = stream.str();
+  REQUIRE(str.size() == bytes_written);
+
+  std::vector<uint8_t> bytes(str.begin(), str.end());
+  std::error_code ec;
+  auto recovered = deserialize<my_struct>(bytes, ec);
+  REQUIRE((bool)ec == false);
+  check_struct(recovered);
+}
+
+TEST_CASE("Serialize to custom sink - one write per value" *
+          test_suite("sink")) {
+  counting_sink sink;
+  auto bytes_written = serialize(make_struct(), sink);
+  REQUIRE(sink.bytes.size() == bytes_written);
+
+  // reserve is called once with the exact size
+  REQUIRE(sink.num_reserves == 1);
+  REQUIRE(sink.reserved == bytes_written);
+
+  // a:        1 (varint)
+  // b:        2 (size + characters)
+  // c:        2 (size + floats)
+  // d:        1 (size) + 2 * (2 (key) + 1 (value))
+  REQUIRE(sink.num_writes == 1 + 2 + 2 + 1 + 2 * 3);
+}
+
+TEST_CASE("Serialize to sink with version and checksum" * test_suite("sink")) {
+  constexpr auto OPTIONS = options::with_version | options::with_checksum;
+
+  std::vector<uint8_t> expected;
+  serialize<OPTIONS>(make_struct(), expected);
+
+  std::ostringstream stream;
+  ostream_sink sink{stream};
+  auto bytes_written = serialize<OPTIONS>(make_struct(), sink);
+  REQUIRE(bytes_written == expected.size());
+
+  const auto str = stream.str();
+  std::vector<uint8_t> bytes(str.begin(), str.end());
+  REQUIRE(bytes == expected);
+
+  std::error_code ec;
+  auto recovered = deserialize<OPTIONS, my_struct>(bytes, ec);
+  REQUIRE((bool)ec == false);
+  check_struct(recovered);
+}
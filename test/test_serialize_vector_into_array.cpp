@@ -103,18 +103,11 @@ TEST_CASE("Serialize vector<bool> into array" * test_suite("vector")) {
   my_struct s{{true, false, true, false, true}};
   std::array<uint8_t, 30> bytes;
   auto bytes_written = serialize(s, bytes);
-  REQUIRE(bytes_written == 6);
+  REQUIRE(bytes_written == 2);
   // size
   REQUIRE(bytes[0] == static_cast<uint8_t>(5));
-  // values
-  bool current_value = true;
-  for (std::size_t i = 1; i < bytes_written;) {
-    CONSTRUCT_EXPECTED_VALUE(bool, current_value);
-    current_value = !current_value;
-    for (std::size_t j = 0; j < expected.size(); ++j) {
-      REQUIRE(bytes[i++] == expected[j]);
-    }
-  }
+  // values, packed 8 to a byte
+  REQUIRE(bytes[1] == static_cast<uint8_t>(0b10101));
 }
 #endif
 
@@ -0,0 +1,168 @@
+#include <alpaca/alpaca.h>
+#include <doctest.hpp>
+#include <filesystem>
+#include <sstream>
+using namespace alpaca;
+
+using doctest::test_suite;
+
+namespace {
+
+struct my_struct {
+  std::vector<uint16_t> values;
+  std::string name;
+  std::map<int, int> map;
+};
+
+my_struct make_struct() { return {{1, 2, 3}, "wide", {{1, 2}}}; }
+
+void check_struct(const my_struct &s) {
+  REQUIRE(s.values == std::vector<uint16_t>{1, 2, 3});
+  REQUIRE(s.name == "wide");
+  REQUIRE(s.map == std::map<int, int>{{1, 2}});
+}
+
+} // namespace
+
+TEST_CASE("Serialize with wide lengths" * test_suite("wide_lengths")) {
+  // variable-length encoded lengths below 2^32 are unchanged
+  std::vector<uint8_t> bytes, wide_bytes;
+  serialize(make_struct(), bytes);
+  serialize<options::wide_lengths>(make_struct(), wide_bytes);
+  REQUIRE(bytes == wide_bytes);
+
+  std::error_code ec;
+  check_struct(deserialize<options::wide_lengths, my_struct>(bytes, ec));
+  REQUIRE((bool)ec == false);
+
+  // with fixed length encoding, every length takes up 8 bytes
+  constexpr auto O = options::wide_lengths | options::fixed_length_encoding;
+  bytes.clear();
+  serialize<O>(make_struct(), bytes);
+  REQUIRE(bytes.size() == (8 + 3 * 2) + (8 + 4) + (8 + 2 * 4));
+
+  REQUIRE(validate<my_struct, O>(bytes, ec));
+  check_struct(deserialize<O, my_struct>(bytes, ec));
+  REQUIRE((bool)ec == false);
+
+  ec.clear();
+  deserialize<O, my_struct>(bytes, 7, ec);
+  REQUIRE(ec == std::errc::message_size);
+}
+
+TEST_CASE("Serialize length that does not fit" * test_suite("wide_lengths")) {
+  if (sizeof(std::size_t) <= sizeof(uint32_t)) {
+    return;
+  }
+  const auto size = static_cast<std::size_t>((uint64_t{1} << 32) + 5);
+
+  detail::byte_counter counter;
+  std::size_t byte_index = 0;
+  detail::to_bytes_size<options::none>(counter, byte_index, size);
+  REQUIRE(counter.size_too_large);
+
+  counter = {};
+  detail::to_bytes_size<options::wide_lengths>(counter, byte_index, size);
+  REQUIRE(counter.size_too_large == false);
+
+  // only counted, the characters are never read
+  struct view_struct {
+    std::string_view value;
+  };
+  const char c = 'a';
+  const view_struct s{std::string_view{&c, size}};
+
+  std::error_code ec;
+  serialized_size(s, ec);
+  REQUIRE(ec == std::errc::value_too_large);
+
+  ec.clear();
+  std::vector<uint8_t> bytes;
+  REQUIRE(serialize(s, bytes, ec) == 0);
+  REQUIRE(ec == std::errc::value_too_large);
+  REQUIRE(bytes.empty());
+
+  ec.clear();
+  std::ostringstream stream;
+  ostream_sink sink{stream};
+  REQUIRE(serialize(s, sink, ec) == 0);
+  REQUIRE(ec == std::errc::value_too_large);
+  REQUIRE(stream.str().empty());
+
+  const auto filename = "test_wide_lengths.bin";
+  {
+    ec.clear();
+    std::ofstream os(filename, std::ios::out | std::ios::binary);
+    REQUIRE(serialize(s, os, ec) == 0);
+    REQUIRE(ec == std::errc::value_too_large);
+  }
+  REQUIRE(std::filesystem::file_size(filename) == 0);
+  std::filesystem::remove(filename);
+
+  ec.clear();
+  uint8_t buffer[16];
+  REQUIRE(serialize(s, buffer, ec) == 0);
+  REQUIRE(ec == std::errc::value_too_large);
+
+  ec.clear();
+  REQUIRE(serialized_size<options::wide_lengths>(s, ec) == 5 + size);
+  REQUIRE((bool)ec == false);
+}
+
+TEST_CASE("Deserialize length that does not fit in the input" *
+          test_suite("wide_lengths")) {
+  constexpr auto O = options::wide_lengths | options::fixed_length_encoding;
+
+  // 8-byte length prefix of 2^63, followed by 2 bytes
+  std::vector<uint8_t> bytes{0, 0, 0, 0, 0, 0, 0, 0x80, 'a', 'b'};
+
+  struct u16_struct {
+    std::u16string_view value;
+  };
+  std::error_code ec;
+  REQUIRE(validate<u16_struct, O>(bytes, ec) == false);
+  REQUIRE(ec == std::errc::value_too_large);
+  ec.clear();
+  deserialize<O, u16_struct>(bytes, ec);
+  REQUIRE(ec == std::errc::value_too_large);
+
+#ifdef __cpp_lib_span
+  struct span_struct {
+    std::span<const uint64_t> values;
+  };
+  ec.clear();
+  REQUIRE(validate<span_struct, O>(bytes, ec) == false);
+  REQUIRE(ec == std::errc::value_too_large);
+  ec.clear();
+  deserialize<O, span_struct>(bytes, ec);
+  REQUIRE(ec == std::errc::value_too_large);
+#endif
+
+  // 2^64 - 1 bits
+  std::fill(bytes.begin(), bytes.begin() + 8, 0xff);
+
+  struct bits_struct {
+    std::vector<bool> bits;
+  };
+  ec.clear();
+  REQUIRE(validate<bits_struct, O>(bytes, ec) == false);
+  REQUIRE(ec == std::errc::value_too_large);
+  ec.clear();
+  deserialize<O, bits_struct>(bytes, ec);
+  REQUIRE(ec == std::errc::value_too_large);
+}
+
+TEST_CASE("Serialize with error code" * test_suite("wide_lengths")) {
+  std::vector<uint8_t> bytes{0xff};
+  std::error_code ec;
+  auto bytes_written = serialize(make_struct(), bytes, ec);
+  REQUIRE((bool)ec == false);
+  REQUIRE(bytes_written == bytes.size() - 1);
+
+  std::size_t byte_index = 1;
+  std::size_t end_index = bytes.size();
+  my_struct s{};
+  deserialize(s, bytes, byte_index, end_index, ec);
+  REQUIRE((bool)ec == false);
+  check_struct(s);
+}
@@ -0,0 +1,131 @@
+#include <alpaca/alpaca.h>
+#include <doctest.hpp>
+using namespace alpaca;
+
+using doctest::test_suite;
+
+TEST_CASE("Serialized size of fundamental types" *
+          test_suite("serialized_size")) {
+  struct my_struct {
+    bool a;
+    char b;
+    uint16_t c;
+    int d;
+    uint64_t e;
+    float f;
+    double g;
+  };
+
+  my_struct s{true, 'x', 5, -300, 1000000, 3.14f, 2.71};
+
+  std::vector<uint8_t> bytes;
+  auto bytes_written = serialize(s, bytes);
+  REQUIRE(serialized_size(s) == bytes_written);
+  REQUIRE(bytes.size() == bytes_written);
+}
+
+TEST_CASE("Serialized size of nested containers" *
+          test_suite("serialized_size")) {
+  struct inner {
+    std::string name;
+    std::vector<int> value;
+  };
+
+  struct my_struct {
+    std::vector<inner> a;
+    std::map<std::string, std::vector<uint32_t>> b;
+    std::variant<int, std::string> c;
+    std::unique_ptr<inner> d;
+    std::tuple<int, std::set<char>> e;
+  };
+
+  my_struct s{{{"abc", {5}}, {"defghi", {}}},
+              {{"x", {1, 200, 300000}}, {"yz", {}}},
+              std::string{"variant"},
+              std::make_unique<inner>(inner{"nested", {100, -100}}),
+              {-1, {'a', 'b'}}};
+
+  std::vector<uint8_t> bytes;
+  auto bytes_written = serialize(s, bytes);
+  REQUIRE(serialized_size(s) == bytes_written);
+  REQUIRE(bytes.size() == bytes_written);
+}
+
+TEST_CASE("Serialized size with options" * test_suite("serialized_size")) {
+  struct my_struct {
+    std::string a;
+    std::vector<int64_t> b;
+    uint32_t c;
+  };
+
+  my_struct s{"Hello World", {-1, 1, 100000, -100000}, 123456};
+
+  {
+    constexpr auto OPTIONS = options::with_version | options::with_checksum;
+    std::vector<uint8_t> bytes;
+    auto bytes_written = serialize<OPTIONS>(s, bytes);
+    REQUIRE(serialized_size<OPTIONS>(s) == bytes_written);
+    REQUIRE(bytes.size() == bytes_written);
+
+    std::error_code ec;
+    auto recovered = deserialize<OPTIONS, my_struct>(bytes, ec);
+    REQUIRE((bool)ec == false);
+    REQUIRE(recovered.a == s.a);
+    REQUIRE(recovered.b == s.b);
+    REQUIRE(recovered.c == s.c);
+  }
+
+  {
+    constexpr auto OPTIONS =
+        options::big_endian | options::fixed_length_encoding;
+    std::vector<uint8_t> bytes;
+    auto bytes_written = serialize<OPTIONS>(s, bytes);
+    REQUIRE(serialized_size<OPTIONS>(s) == bytes_written);
+    REQUIRE(bytes_written == 4 + 11 + 4 + 4 * 8 + 4);
+  }
+}
+
+TEST_CASE("Serialize to vector grows it exactly once" *
+          test_suite("serialized_size")) {
+  struct my_struct {
+    std::vector<std::string> values;
+  };
+
+  my_struct s;
+  for (int i = 0; i < 1000; ++i) {
+    s.values.push_back("value " + std::to_string(i));
+  }
+
+  std::vector<uint8_t> bytes;
+  auto bytes_written = serialize(s, bytes);
+  REQUIRE(bytes.size() == bytes_written);
+  REQUIRE(bytes.capacity() == bytes_written);
+
+  std::error_code ec;
+  auto recovered = deserialize<my_struct>(bytes, ec);
+  REQUIRE((bool)ec == false);
+  REQUIRE(recovered.values == s.values);
+}
+
+TEST_CASE("Serialize appends to a non-empty vector" *
+          test_suite("serialized_size")) {
+  struct my_struct {
+    uint16_t a;
+    std::string b;
+  };
+
+  my_struct s{0x0102, "abc"};
+
+  std::vector<uint8_t> bytes{0xff, 0xfe};
+  auto bytes_written = serialize(s, bytes);
+  REQUIRE(bytes_written == 6);
+  REQUIRE(bytes.size() == 8);
+  REQUIRE(bytes[0] == 0xff);
+  REQUIRE(bytes[1] == 0xfe);
+  REQUIRE(bytes[2] == 0x02);
+  REQUIRE(bytes[3] == 0x01);
+  REQUIRE(bytes[4] == 3);
+  REQUIRE(bytes[5] == 'a');
+  REQUIRE(bytes[6] == 'b');
+  REQUIRE(bytes[7] == 'c');
+}
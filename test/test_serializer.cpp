@@ -0,0 +1,72 @@
+#include <alpaca/alpaca.h>
+#include <doctest.hpp>
+using namespace alpaca;
+
+using doctest::test_suite;
+
+namespace {
+
+struct message {
+  uint32_t id;
+  std::string text;
+  std::vector<int> values;
+};
+
+} // namespace
+
+TEST_CASE("serializer produces the same bytes as serialize" *
+          test_suite("serializer")) {
+  message m{5, "Hello World", {1, -2, 300}};
+
+  std::vector<uint8_t> expected;
+  serialize(m, expected);
+
+  serializer<message> s;
+  const auto &bytes = s.serialize(m);
+  REQUIRE(bytes == expected);
+  REQUIRE(s.bytes() == expected);
+}
+
+TEST_CASE("serializer reuses its buffer" * test_suite("serializer")) {
+  constexpr auto OPTIONS = options::with_version | options::with_checksum;
+
+  serializer<message, OPTIONS> s(256);
+  REQUIRE(s.capacity() >= 256);
+  const auto capacity = s.capacity();
+  const auto *data = s.bytes().data();
+
+  for (uint32_t i = 0; i < 1000; ++i) {
+    message m{i, "message " + std::to_string(i), {int(i), -int(i)}};
+    const auto &bytes = s.serialize(m);
+
+    // no reallocation
+    REQUIRE(s.capacity() == capacity);
+    REQUIRE(bytes.data() == data);
+
+    std::vector<uint8_t> expected;
+    serialize<OPTIONS>(m, expected);
+    REQUIRE(bytes == expected);
+
+    std::error_code ec;
+    auto recovered = deserialize<OPTIONS, message>(bytes, ec);
+    REQUIRE((bool)ec == false);
+    REQUIRE(recovered.id == m.id);
+    REQUIRE(recovered.text == m.text);
+    REQUIRE(recovered.values == m.values);
+  }
+}
+
+TEST_CASE("serializer grows for larger objects" * test_suite("serializer")) {
+  serializer<message> s;
+  message small{1, "a", {}};
+  message large{2, std::string(1000, 'x'), std::vector<int>(100, 7)};
+
+  REQUIRE(s.serialize(small).size() == serialized_size(small));
+  REQUIRE(s.serialize(large).size() == serialized_size(large));
+  REQUIRE(s.capacity() >= serialized_size(large));
+
+  // shrinking back does not release the capacity
+  const auto capacity = s.capacity();
+  REQUIRE(s.serialize(small).size() == serialized_size(small));
+  REQUIRE(s.capacity() == capacity);
+}
@@ -0,0 +1,275 @@
+#include <alpaca/alpaca.h>
+#include <doctest.hpp>
+using namespace alpaca;
+
+using doctest::test_suite;
+
+namespace {
+
+enum class color { red, green, blue };
+
+struct nested {
+  int a;
+  std::string b;
+};
+
+struct validate_struct {
+  bool flag;
+  uint32_t count;
+  int64_t offset;
+  color c;
+  std::string name;
+  std::vector<nested> items;
+  std::map<std::string, std::vector<float>> table;
+  std::vector<std::optional<uint64_t>> maybe;
+  std::variant<int, std::string, double> choice;
+  std::array<uint16_t, 3> triple;
+  std::tuple<char, std::set<int>> pair_like;
+  std::unique_ptr<nested> ptr;
+};
+
+validate_struct make_validate_struct() {
+  validate_struct s{};
+  s.flag = true;
+  s.count = 0xffffffff;
+  s.offset = -1234567890123;
+  s.c = color::blue;
+  s.name = "validate";
+  s.items = {{1, "one"}, {-2, "two"}};
+  s.table = {{"x", {1.5f, 2.5f}}, {"y", {}}};
+  s.maybe = {std::nullopt, 42, std::numeric_limits<uint64_t>::max()};
+  s.choice = std::string{"variant"};
+  s.triple = {1, 2, 3};
+  s.pair_like = {'z', {3, 1, 2}};
+  s.ptr = std::unique_ptr<nested>(new nested{7, "seven"});
+  return s;
+}
+
+} // namespace
+
+TEST_CASE("Validate well-formed input" * test_suite("validate")) {
+  std::vector<uint8_t> bytes;
+  serialize(make_validate_struct(), bytes);
+
+  std::error_code ec;
+  REQUIRE(validate<validate_struct>(bytes, ec));
+  REQUIRE((bool)ec == false);
+
+  // validated input can be deserialized without the per-value checks
+  auto trusted =
+      deserialize<options::trusted_input, validate_struct>(bytes, ec);
+  REQUIRE((bool)ec == false);
+  auto checked = deserialize<validate_struct>(bytes, ec);
+  REQUIRE((bool)ec == false);
+
+  REQUIRE(trusted.flag == checked.flag);
+  REQUIRE(trusted.count == 0xffffffff);
+  REQUIRE(trusted.offset == checked.offset);
+  REQUIRE(trusted.c == color::blue);
+  REQUIRE(trusted.name == checked.name);
+  REQUIRE(trusted.items.size() == 2);
+  REQUIRE(trusted.items[1].b == "two");
+  REQUIRE(trusted.table == checked.table);
+  REQUIRE(trusted.maybe == checked.maybe);
+  REQUIRE(trusted.maybe[2] == std::numeric_limits<uint64_t>::max());
+  REQUIRE(std::get<1>(trusted.choice) == "variant");
+  REQUIRE(trusted.triple == checked.triple);
+  REQUIRE(trusted.pair_like == checked.pair_like);
+  REQUIRE(trusted.ptr->b == "seven");
+}
+
+TEST_CASE("Validate rejects every truncation" * test_suite("validate")) {
+  std::vector<uint8_t> bytes;
+  serialize(make_validate_struct(), bytes);
+
+  // any prefix either is a valid message written by an older version of the
+  // struct, or is rejected - and whatever validates also deserializes
+  for (std::size_t size = 1; size < bytes.size(); ++size) {
+    std::error_code validate_ec;
+    const bool valid = validate<validate_struct>(bytes, size, validate_ec);
+    REQUIRE(valid == !validate_ec);
+
+    std::error_code deserialize_ec;
+    deserialize<validate_struct>(bytes, size, deserialize_ec);
+    if (valid) {
+      REQUIRE((bool)deserialize_ec == false);
+    }
+  }
+}
+
+TEST_CASE("Validate truncated varint" * test_suite("validate")) {
+  struct my_struct {
+    uint32_t a;
+  };
+
+  std::vector<uint8_t> bytes;
+  serialize(my_struct{0xffffffff}, bytes);
+  REQUIRE(bytes.size() == 5);
+
+  std::error_code ec;
+  REQUIRE(validate<my_struct>(bytes, 3, ec) == false);
+  REQUIRE(ec == std::errc::message_size);
+
+  // the decoder rejects it too, instead of reading past the end
+  ec.clear();
+  deserialize<my_struct>(bytes, 3, ec);
+  REQUIRE(ec == std::errc::message_size);
+}
+
+TEST_CASE("Validate overlong varint" * test_suite("validate")) {
+  struct my_struct {
+    uint32_t a;
+  };
+
+  // continuation flag on every byte
+  std::vector<uint8_t> bytes{0xff, 0xff, 0xff, 0xff, 0xff, 0xff};
+
+  std::error_code ec;
+  REQUIRE(validate<my_struct>(bytes, ec) == false);
+  REQUIRE(ec == std::errc::illegal_byte_sequence);
+}
+
+TEST_CASE("Validate truncated fixed-length value" * test_suite("validate")) {
+  struct my_struct {
+    uint16_t a;
+    double b;
+  };
+
+  std::vector<uint8_t> bytes;
+  serialize(my_struct{5, 3.14}, bytes);
+  REQUIRE(bytes.size() == 10);
+
+  std::error_code ec;
+  REQUIRE(validate<my_struct>(bytes, 9, ec) == false);
+  REQUIRE(ec == std::errc::message_size);
+
+  ec.clear();
+  deserialize<my_struct>(bytes, 9, ec);
+  REQUIRE(ec == std::errc::message_size);
+}
+
+TEST_CASE("Validate bool, optional and variant tags" * test_suite("validate")) {
+  struct my_struct {
+    bool a;
+    std::vector<std::optional<int>> b;
+    std::variant<int, float> c;
+  };
+
+  std::vector<uint8_t> bytes;
+  serialize(my_struct{true, {5}, 1.0f}, bytes);
+  // bool, size, has_value, value, index, float
+  REQUIRE(bytes.size() == 9);
+
+  std::error_code ec;
+  REQUIRE(validate<my_struct>(bytes, ec));
+
+  {
+    auto bad = bytes;
+    bad[0] = 2;
+    ec.clear();
+    REQUIRE(validate<my_struct>(bad, ec) == false);
+    REQUIRE(ec == std::errc::illegal_byte_sequence);
+  }
+  {
+    auto bad = bytes;
+    bad[2] = 7;
+    ec.clear();
+    REQUIRE(validate<my_struct>(bad, ec) == false);
+    REQUIRE(ec == std::errc::illegal_byte_sequence);
+  }
+  {
+    auto bad = bytes;
+    bad[4] = 2;
+    ec.clear();
+    REQUIRE(validate<my_struct>(bad, ec) == false);
+    REQUIRE(ec == std::errc::illegal_byte_sequence);
+  }
+}
+
+TEST_CASE("Validate length prefix" * test_suite("validate")) {
+  struct my_struct {
+    std::vector<uint64_t> a;
+    std::string b;
+  };
+
+  std::vector<uint8_t> bytes;
+  serialize(my_struct{{1, 2, 3}, "abc"}, bytes);
+
+  std::error_code ec;
+  REQUIRE(validate<my_struct>(bytes, ec));
+
+  // claims more elements than there are bytes left
+  auto bad = bytes;
+  bad[0] = 100;
+  ec.clear();
+  REQUIRE(validate<my_struct>(bad, ec) == false);
+  REQUIRE(ec == std::errc::value_too_large);
+
+  // cuts off the string
+  ec.clear();
+  REQUIRE(validate<my_struct>(bytes, bytes.size() - 1, ec) == false);
+  REQUIRE(ec == std::errc::value_too_large);
+}
+
+TEST_CASE("Validate version and checksum" * test_suite("validate")) {
+  struct my_struct {
+    int a;
+    std::string b;
+  };
+
+  struct other_struct {
+    std::string b;
+    int a;
+  };
+
+  constexpr auto O = options::with_version | options::with_checksum;
+
+  std::vector<uint8_t> bytes;
+  serialize<O>(my_struct{5, "hello"}, bytes);
+
+  std::error_code ec;
+  REQUIRE(validate<my_struct, O>(bytes, ec));
+
+  ec.clear();
+  REQUIRE(validate<other_struct, O>(bytes, ec) == false);
+  REQUIRE(ec == std::errc::invalid_argument);
+
+  auto bad = bytes;
+  bad[6] ^= 0x01;
+  ec.clear();
+  REQUIRE(validate<my_struct, O>(bad, ec) == false);
+  REQUIRE(ec == std::errc::bad_message);
+
+  // the checksum is not computed again for trusted input
+  ec.clear();
+  auto s = deserialize<O | options::trusted_input, my_struct>(bytes, ec);
+  REQUIRE((bool)ec == false);
+  REQUIRE(s.a == 5);
+  REQUIRE(s.b == "hello");
+}
+
+TEST_CASE("Validate with fixed length encoding" * test_suite("validate")) {
+  struct my_struct {
+    uint64_t a;
+    std::vector<int32_t> b;
+  };
+
+  constexpr auto O = options::fixed_length_encoding;
+
+  std::vector<uint8_t> bytes;
+  serialize<O>(my_struct{std::numeric_limits<uint64_t>::max(), {-1, 2}},
+               bytes);
+  REQUIRE(bytes.size() == 8 + 4 + 8);
+
+  std::error_code ec;
+  REQUIRE(validate<my_struct, O>(bytes, ec));
+
+  ec.clear();
+  REQUIRE(validate<my_struct, O>(bytes, bytes.size() - 2, ec) == false);
+
+  ec.clear();
+  auto s = deserialize<O | options::trusted_input, my_struct>(bytes, ec);
+  REQUIRE((bool)ec == false);
+  REQUIRE(s.a == std::numeric_limits<uint64_t>::max());
+  REQUIRE(s.b == std::vector<int32_t>{-1, 2});
+}
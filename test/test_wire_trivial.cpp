@@ -0,0 +1,164 @@
+#include <alpaca/alpaca.h>
+#include <cstring>
+#include <doctest.hpp>
+using namespace alpaca;
+
+using doctest::test_suite;
+
+namespace {
+
+struct vec3 {
+  float x;
+  float y;
+  float z;
+};
+
+struct triangle {
+  vec3 v0;
+  vec3 v1;
+  vec3 v2;
+  vec3 normal;
+};
+
+struct padded {
+  uint8_t a;
+  uint16_t b;
+};
+
+struct with_varint {
+  uint32_t a;
+  int32_t b;
+};
+
+enum class color : uint16_t { red, green, blue };
+
+} // namespace
+
+TEST_CASE("is_wire_trivial" * test_suite("wire_trivial")) {
+  static_assert(is_wire_trivial_v<float>);
+  static_assert(is_wire_trivial_v<uint16_t>);
+  static_assert(is_wire_trivial_v<color>);
+  static_assert(is_wire_trivial_v<vec3>);
+  static_assert(is_wire_trivial_v<triangle>);
+  static_assert(is_wire_trivial_v<std::array<double, 4>>);
+
+  // bool, padding, variable-length encoding and STL containers
+  static_assert(!is_wire_trivial_v<bool>);
+  static_assert(!is_wire_trivial_v<padded>);
+  static_assert(!is_wire_trivial_v<uint32_t>);
+  static_assert(!is_wire_trivial_v<with_varint>);
+  static_assert(!is_wire_trivial_v<std::string>);
+  static_assert(!is_wire_trivial_v<std::vector<float>>);
+
+  // 32/64-bit integers are only trivial with fixed length encoding
+  static_assert(is_wire_trivial_v<uint32_t, options::fixed_length_encoding>);
+  static_assert(is_wire_trivial_v<with_varint, options::fixed_length_encoding>);
+
+  // byte swapping is required when the byte order does not match the system
+  if constexpr (detail::is_system_little_endian()) {
+    static_assert(!is_wire_trivial_v<float, options::big_endian>);
+    static_assert(!is_wire_trivial_v<triangle, options::big_endian>);
+    static_assert(is_wire_trivial_v<char, options::big_endian>);
+  }
+}
+
+TEST_CASE("Serialize vector<triangle> as contiguous bytes" *
+          test_suite("wire_trivial")) {
+  struct mesh {
+    std::vector<triangle> triangles;
+  };
+
+  mesh m;
+  for (int i = 0; i < 100; ++i) {
+    const auto f = static_cast<float>(i);
+    m.triangles.push_back({{f, f + 1, f + 2},
+                           {f + 3, f + 4, f + 5},
+                           {f + 6, f + 7, f + 8},
+                           {0.0f, 0.0f, 1.0f}});
+  }
+
+  std::vector<uint8_t> bytes;
+  auto bytes_written = serialize(m, bytes);
+  const auto num_bytes = m.triangles.size() * sizeof(triangle);
+  // 100 encoded as a single byte varint
+  REQUIRE(bytes_written == 1 + num_bytes);
+  REQUIRE(bytes[0] == 100);
+  REQUIRE(std::memcmp(bytes.data() + 1, m.triangles.data(), num_bytes) == 0);
+
+  std::error_code ec;
+  auto recovered = deserialize<mesh>(bytes, ec);
+  REQUIRE((bool)ec == false);
+  REQUIRE(recovered.triangles.size() == m.triangles.size());
+  REQUIRE(std::memcmp(recovered.triangles.data(), m.triangles.data(),
+                      num_bytes) == 0);
+}
+
+TEST_CASE("Serialize vector<triangle> into array with options" *
+          test_suite("wire_trivial")) {
+  struct mesh {
+    std::vector<triangle> triangles;
+    std::array<uint64_t, 2> ids;
+  };
+
+  constexpr auto OPTIONS = options::fixed_length_encoding;
+
+  mesh m{{{{1, 2, 3}, {4, 5, 6}, {7, 8, 9}, {0, 0, 1}},
+          {{-1, -2, -3}, {-4, -5, -6}, {-7, -8, -9}, {0, 1, 0}}},
+         {0xdeadbeefcafebabe, 5}};
+
+  std::array<uint8_t, 200> bytes;
+  auto bytes_written = serialize<OPTIONS>(m, bytes);
+  REQUIRE(bytes_written == 4 + 2 * sizeof(triangle) + 2 * sizeof(uint64_t));
+
+  std::error_code ec;
+  auto recovered = deserialize<OPTIONS, mesh>(bytes, bytes_written, ec);
+  REQUIRE((bool)ec == false);
+  REQUIRE(recovered.triangles.size() == 2);
+  REQUIRE(recovered.triangles[1].v2.z == -9);
+  REQUIRE(recovered.triangles[1].normal.y == 1);
+  REQUIRE(recovered.ids == m.ids);
+}
+
+TEST_CASE("Serialize vector<triangle> big endian" *
+          test_suite("wire_trivial")) {
+  struct mesh {
+    std::vector<triangle> triangles;
+  };
+
+  constexpr auto OPTIONS = options::big_endian;
+
+  mesh m{{{{1, 2, 3}, {4, 5, 6}, {7, 8, 9}, {0, 0, 1}}}};
+
+  std::vector<uint8_t> bytes;
+  serialize<OPTIONS>(m, bytes);
+
+  // 4 byte size followed by the first float as big endian 1.0f
+  REQUIRE(bytes.size() == 4 + sizeof(triangle));
+  REQUIRE(bytes[4] == 0x3f);
+  REQUIRE(bytes[5] == 0x80);
+  REQUIRE(bytes[6] == 0x00);
+  REQUIRE(bytes[7] == 0x00);
+
+  std::error_code ec;
+  auto recovered = deserialize<OPTIONS, mesh>(bytes, ec);
+  REQUIRE((bool)ec == false);
+  REQUIRE(recovered.triangles.size() == 1);
+  REQUIRE(recovered.triangles[0].v1.y == 5);
+  REQUIRE(recovered.triangles[0].normal.z == 1);
+}
+
+TEST_CASE("Deserialize vector<float> error - size value_too_large" *
+          test_suite("wire_trivial")) {
+  struct my_struct {
+    std::vector<float> values;
+  };
+
+  // size is 0xff which is too large since there are only 3 bytes
+  // left in the buffer
+  auto bytes = std::vector<uint8_t>{0xff, 0x01, 0x02, 0x03};
+
+  std::error_code ec;
+  auto result = deserialize<my_struct>(bytes, ec);
+  REQUIRE((bool)ec == true);
+  REQUIRE(ec.value() == static_cast<int>(std::errc::value_too_large));
+}